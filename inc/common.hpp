@@ -4,6 +4,7 @@
 #define WLKIT_COMMON_H
 
 #include <cstdint>
+#include <ctime>
 #include <variant>
 #include <functional>
 #include <list>
@@ -32,20 +33,40 @@ namespace wlkit {
 
 using Geo = double;
 using Time = uint32_t;
+using Nsec = int64_t;
+
+inline Nsec timespec_to_nsec(const struct timespec & ts) {
+	return static_cast<Nsec>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+inline Nsec monotonic_nsec() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return timespec_to_nsec(now);
+}
 
 class Seat;
 class Server;
+class LoopMonitor;
 class Root;
 class Node;
 class Cursor;
 class Output;
 class OutputStateBuilder;
+class FrameStats;
+class OutputLayers;
+class LatencyHistogram;
 class Render;
+class DisplayList;
 class Workspace;
-class WorkspacesHistory;
+class WindowGrid;
 class Layout;
 class Window;
-class WindowsHistory;
+class Thumbnail;
+template <typename T> class History;
+using WorkspacesHistory = History<Workspace*>;
+using WindowsHistory = History<Window*>;
+class Overview;
 class Input;
 class Surface;
 
@@ -6,6 +6,7 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
 
 namespace wlkit {
 
@@ -22,8 +23,8 @@ private:
 
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Cursor::on_create"};
+	HandlerList<Handler> _on_destroy{"Cursor::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -38,11 +39,16 @@ public:
 	[[nodiscard]] Root * root() const;
 	[[nodiscard]] struct ::wlr_cursor * wlr_cursor() const;
 	[[nodiscard]] struct ::wlr_xcursor_manager * wlr_xcursor_manager() const;
+	[[nodiscard]] Geo x() const;
+	[[nodiscard]] Geo y() const;
 	[[nodiscard]] void * data() const;
 
+	Cursor & attach(struct ::wlr_input_device * device);
+	Cursor & detach(struct ::wlr_input_device * device);
+	Cursor & set_image(const char * name);
 	Cursor & set_data(void * data);
 
-	Cursor & on_destroy(const Handler & handler);
+	Cursor & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
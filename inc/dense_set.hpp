@@ -0,0 +1,99 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+
+namespace wlkit {
+
+// items packed in one vector, an index map gives O(1) insert, erase and lookup.
+// erase moves the last item into the gap, so order is insertion order only until the first erase.
+// views and iterators stay valid until the next insert, erase or clear
+template <typename T>
+class DenseSet {
+public:
+	using Iterator = typename std::vector<T>::const_iterator;
+
+private:
+	std::vector<T> _items;
+	std::unordered_map<T, size_t> _index;
+
+public:
+	DenseSet() = default;
+
+	bool insert(const T & item) {
+		if (!_index.emplace(item, _items.size()).second) {
+			return false;
+		}
+		_items.push_back(item);
+		return true;
+	}
+
+	bool erase(const T & item) {
+		auto it = _index.find(item);
+		if (it == _index.end()) {
+			return false;
+		}
+
+		size_t index = it->second;
+		_index.erase(it);
+		if (index + 1 != _items.size()) {
+			_items[index] = std::move(_items.back());
+			_index[_items[index]] = index;
+		}
+		_items.pop_back();
+		return true;
+	}
+
+	DenseSet & clear() {
+		_items.clear();
+		_index.clear();
+		return *this;
+	}
+
+	DenseSet & reserve(size_t size) {
+		_items.reserve(size);
+		_index.reserve(size);
+		return *this;
+	}
+
+	[[nodiscard]] bool contains(const T & item) const {
+		return _index.contains(item);
+	}
+
+	[[nodiscard]] bool empty() const {
+		return _items.empty();
+	}
+
+	[[nodiscard]] size_t size() const {
+		return _items.size();
+	}
+
+	[[nodiscard]] const T & front() const {
+		return _items.front();
+	}
+
+	[[nodiscard]] const T & operator[](size_t index) const {
+		return _items[index];
+	}
+
+	[[nodiscard]] const T * data() const {
+		return _items.data();
+	}
+
+	[[nodiscard]] std::span<const T> view() const {
+		return _items;
+	}
+
+	Iterator begin() const {
+		return _items.begin();
+	}
+
+	Iterator end() const {
+		return _items.end();
+	}
+};
+
+}
@@ -52,11 +52,11 @@ private:
 	char * _variant;
 	char * _options;
 
-	std::list<KeyHandler> _on_key;
-	std::list<KeyStateHandler> _on_key_pressed;
-	std::list<KeyStateHandler> _on_key_released;
-	std::list<ModHandler> _on_mod;
-	std::list<RepeatHandler> _on_repeat;
+	HandlerList<KeyHandler> _on_key{"Keyboard::on_key"};
+	HandlerList<KeyStateHandler> _on_key_pressed{"Keyboard::on_key_pressed"};
+	HandlerList<KeyStateHandler> _on_key_released{"Keyboard::on_key_released"};
+	HandlerList<ModHandler> _on_mod{"Keyboard::on_mod"};
+	HandlerList<RepeatHandler> _on_repeat{"Keyboard::on_repeat"};
 
 	struct ::wl_listener _key_listener;
 	struct ::wl_listener _mod_listener;
@@ -94,11 +94,11 @@ public:
 	Keyboard & set_variant(const char * variant = nullptr);
 	Keyboard & set_options(const char * options = nullptr);
 
-	Keyboard & on_key(const KeyHandler & handler);
-	Keyboard & on_key_pressed(const KeyStateHandler & handler);
-	Keyboard & on_key_released(const KeyStateHandler & handler);
-	Keyboard & on_mod(const ModHandler & handler);
-	Keyboard & on_repeat(const RepeatHandler & handler);
+	Keyboard & on_key(const KeyHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Keyboard & on_key_pressed(const KeyStateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Keyboard & on_key_released(const KeyStateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Keyboard & on_mod(const ModHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Keyboard & on_repeat(const RepeatHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_key(struct ::wl_listener * listener, void * data);
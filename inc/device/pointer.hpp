@@ -49,21 +49,22 @@ private:
 	// struct ::wlr_pointer_constraints_v1 * _constraints;
 	// std::map<Surface*, struct ::wlr_pointer_constraint_v1*> _constraints_by_surface;
 
-	std::list<Handler> _on_destroy;
-	std::list<MotionHandler> _on_motion;
-	std::list<ButtonHandler> _on_button;
-	std::list<AxisHandler> _on_axis;
-	std::list<ActionBeginHandler> _on_swipe_begin;
-	std::list<SwipeUpdateHandler> _on_swipe_update;
-	std::list<ActionEndHandler> _on_swipe_end;
-	std::list<ActionBeginHandler> _on_pinch_begin;
-	std::list<PinchUpdateHandler> _on_pinch_update;
-	std::list<ActionEndHandler> _on_pinch_end;
-	std::list<ActionBeginHandler> _on_hold_begin;
-	std::list<ActionEndHandler> _on_hold_end;
+	HandlerList<Handler> _on_destroy{"Pointer::on_destroy"};
+	HandlerList<MotionHandler> _on_motion{"Pointer::on_motion"};
+	HandlerList<ButtonHandler> _on_button{"Pointer::on_button"};
+	HandlerList<AxisHandler> _on_axis{"Pointer::on_axis"};
+	HandlerList<ActionBeginHandler> _on_swipe_begin{"Pointer::on_swipe_begin"};
+	HandlerList<SwipeUpdateHandler> _on_swipe_update{"Pointer::on_swipe_update"};
+	HandlerList<ActionEndHandler> _on_swipe_end{"Pointer::on_swipe_end"};
+	HandlerList<ActionBeginHandler> _on_pinch_begin{"Pointer::on_pinch_begin"};
+	HandlerList<PinchUpdateHandler> _on_pinch_update{"Pointer::on_pinch_update"};
+	HandlerList<ActionEndHandler> _on_pinch_end{"Pointer::on_pinch_end"};
+	HandlerList<ActionBeginHandler> _on_hold_begin{"Pointer::on_hold_begin"};
+	HandlerList<ActionEndHandler> _on_hold_end{"Pointer::on_hold_end"};
 
 	struct ::wl_listener _destroy_listener;
 	struct ::wl_listener _motion_listener;
+	struct ::wl_listener _motion_absolute_listener;
 	struct ::wl_listener _button_listener;
 	struct ::wl_listener _axis_listener;
 	struct ::wl_listener _swipe_begin_listener;
@@ -100,22 +101,23 @@ public:
 
 	[[nodiscard]] struct ::wlr_pointer * wlr_pointer() const;
 
-	Pointer & on_destroy(const Handler & handler);
-	Pointer & on_motion(const MotionHandler & handler);
-	Pointer & on_button(const ButtonHandler & handler);
-	Pointer & on_axis(const AxisHandler & handler);
-	Pointer & on_swipe_begin(const ActionBeginHandler & handler);
-	Pointer & on_swipe_update(const SwipeUpdateHandler & handler);
-	Pointer & on_swipe_end(const ActionEndHandler & handler);
-	Pointer & on_pinch_begin(const ActionBeginHandler & handler);
-	Pointer & on_pinch_update(const PinchUpdateHandler & handler);
-	Pointer & on_pinch_end(const ActionEndHandler & handler);
-	Pointer & on_hold_begin(const ActionBeginHandler & handler);
-	Pointer & on_hold_end(const ActionEndHandler & handler);
+	Pointer & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_motion(const MotionHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_button(const ButtonHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_axis(const AxisHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_swipe_begin(const ActionBeginHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_swipe_update(const SwipeUpdateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_swipe_end(const ActionEndHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_pinch_begin(const ActionBeginHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_pinch_update(const PinchUpdateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_pinch_end(const ActionEndHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_hold_begin(const ActionBeginHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Pointer & on_hold_end(const ActionEndHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 	static void _handle_motion(struct ::wl_listener * listener, void * data);
+	static void _handle_motion_absolute(struct ::wl_listener * listener, void * data);
 	static void _handle_button(struct ::wl_listener * listener, void * data);
 	static void _handle_axis(struct ::wl_listener * listener, void * data);
 	static void _handle_swipe_begin(struct ::wl_listener * listener, void * data);
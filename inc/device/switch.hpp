@@ -25,9 +25,9 @@ public:
 private:
 	struct ::wlr_switch * _wlr_switch;
 
-	std::list<ToggleHandler> _on_toggle;
-	std::list<ToggleStateHandler> _on_toggle_on;
-	std::list<ToggleStateHandler> _on_toggle_off;
+	HandlerList<ToggleHandler> _on_toggle{"Switch::on_toggle"};
+	HandlerList<ToggleStateHandler> _on_toggle_on{"Switch::on_toggle_on"};
+	HandlerList<ToggleStateHandler> _on_toggle_off{"Switch::on_toggle_off"};
 
 	struct ::wl_listener _toggle_listener;
 
@@ -43,9 +43,9 @@ public:
 
 	[[nodiscard]] struct ::wlr_switch * wlr_switch() const;
 
-	Switch & on_toggle(const ToggleHandler & handler);
-	Switch & on_toggle_on(const ToggleStateHandler & handler);
-	Switch & on_toggle_off(const ToggleStateHandler & handler);
+	Switch & on_toggle(const ToggleHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Switch & on_toggle_on(const ToggleStateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Switch & on_toggle_off(const ToggleStateHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_toggle(struct ::wl_listener * listener, void * data);
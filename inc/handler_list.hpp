@@ -0,0 +1,237 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace wlkit {
+
+class Profiler {
+public:
+	typedef struct {
+		const char * list;
+		std::string name;
+		uint64_t calls;
+		Nsec total;
+		Nsec worst;
+	} Entry;
+
+	class Record {
+	private:
+		const char * _list;
+		std::string _name;
+		uint64_t _calls;
+		Nsec _total;
+		Nsec _worst;
+		struct ::wl_list _link;
+
+		friend class Profiler;
+
+	public:
+		Record(const char * list, const char * name, size_t index);
+		~Record();
+
+		Record(const Record &) = delete;
+		Record & operator=(const Record &) = delete;
+
+		void add(Nsec duration);
+	};
+
+private:
+	static inline bool _enabled = false;
+
+public:
+	static void set_enabled(bool enabled);
+	[[nodiscard]] static bool enabled() {
+		return _enabled;
+	}
+
+	// slowest handlers first, only those called since the last reset
+	[[nodiscard]] static std::vector<Entry> report();
+	static void reset();
+	static void log(enum ::wlr_log_importance verbosity = WLR_INFO);
+};
+
+// token of one connected handler, it does not keep the handler list alive
+class Subscription {
+private:
+	void * _list;
+	bool (*_disconnect)(void * list, uint32_t id);
+	uint32_t _id;
+
+public:
+	Subscription():
+	_list(nullptr), _disconnect(nullptr), _id(0) {}
+
+	Subscription(void * list, bool (*disconnect)(void * list, uint32_t id), uint32_t id):
+	_list(list), _disconnect(disconnect), _id(id) {}
+
+	// call before the object that owns the handler list is destroyed
+	bool disconnect() {
+		if (!_list) {
+			return false;
+		}
+		bool disconnected = _disconnect(_list, _id);
+		_list = nullptr;
+		return disconnected;
+	}
+
+	[[nodiscard]] bool connected() const {
+		return _list != nullptr;
+	}
+};
+
+template <typename Handler>
+class HandlerList {
+private:
+	typedef struct {
+		Handler handler;
+		const char * name;
+		uint32_t id;
+		bool connected;
+		std::unique_ptr<Profiler::Record> record;
+	} Slot;
+
+	// slots are contiguous, handlers connected during an emit wait in pending until it ends
+	typedef struct {
+		std::vector<Slot> slots;
+		std::vector<Slot> pending;
+		uint32_t next_id;
+		uint32_t emitting;
+		bool dirty;
+	} State;
+
+	const char * _name;
+	std::unique_ptr<State> _state;
+
+public:
+	explicit HandlerList(const char * name = ""):
+	_name(name) {}
+
+	HandlerList(const HandlerList &) = delete;
+	HandlerList & operator=(const HandlerList &) = delete;
+
+	HandlerList & push_back(Handler handler, const char * name = nullptr, Subscription * subscription = nullptr) {
+		auto token = connect(std::move(handler), name);
+		if (subscription) {
+			*subscription = token;
+		}
+		return *this;
+	}
+
+	Subscription connect(Handler handler, const char * name = nullptr) {
+		if (!_state) {
+			_state = std::make_unique<State>();
+			_state->next_id = 0;
+			_state->emitting = 0;
+			_state->dirty = false;
+		}
+
+		uint32_t id = _state->next_id++;
+		auto & slots = _state->emitting ? _state->pending : _state->slots;
+		slots.push_back({ std::move(handler), name, id, true, nullptr });
+		return { this, _disconnect, id };
+	}
+
+	bool disconnect(uint32_t id) {
+		if (!_state) {
+			return false;
+		}
+
+		for (auto * slots : { &_state->slots, &_state->pending }) {
+			for (auto & slot : *slots) {
+				if (slot.id == id && slot.connected) {
+					// a running handler may disconnect itself, the slot goes away after the emit
+					slot.connected = false;
+					_state->dirty = true;
+					if (!_state->emitting) {
+						_compact();
+					}
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	template <typename... Args>
+	void emit(Args &&... args) {
+		if (!_state) {
+			return;
+		}
+
+		State * state = _state.get();
+		++state->emitting;
+		size_t size = state->slots.size();
+		for (size_t i = 0; i < size; ++i) {
+			auto & slot = state->slots[i];
+			if (!slot.connected) {
+				continue;
+			}
+			if (!Profiler::enabled()) {
+				slot.handler(args...);
+				continue;
+			}
+
+			Nsec start = monotonic_nsec();
+			slot.handler(args...);
+			Nsec duration = monotonic_nsec() - start;
+			if (!slot.record) {
+				slot.record = std::make_unique<Profiler::Record>(_name, slot.name, slot.id);
+			}
+			slot.record->add(duration);
+		}
+		if (--state->emitting == 0) {
+			_compact();
+		}
+	}
+
+	[[nodiscard]] const char * name() const {
+		return _name;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return size() == 0;
+	}
+
+	[[nodiscard]] size_t size() const {
+		if (!_state) {
+			return 0;
+		}
+
+		size_t size = 0;
+		for (auto * slots : { &_state->slots, &_state->pending }) {
+			for (auto & slot : *slots) {
+				size += slot.connected;
+			}
+		}
+		return size;
+	}
+
+private:
+	void _compact() {
+		if (_state->dirty) {
+			std::erase_if(_state->slots, [](const Slot & slot) {
+				return !slot.connected;
+			});
+			std::erase_if(_state->pending, [](const Slot & slot) {
+				return !slot.connected;
+			});
+			_state->dirty = false;
+		}
+		if (!_state->pending.empty()) {
+			for (auto & slot : _state->pending) {
+				_state->slots.push_back(std::move(slot));
+			}
+			_state->pending.clear();
+		}
+	}
+
+	static bool _disconnect(void * list, uint32_t id) {
+		return static_cast<HandlerList*>(list)->disconnect(id);
+	}
+};
+
+}
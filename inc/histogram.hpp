@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+
+#include "common.hpp"
+
+namespace wlkit {
+
+// log-linear buckets: 4 per power of two from 1 us, ~19% wide, up to ~1 h
+class LatencyHistogram {
+public:
+	static constexpr size_t SUB_BUCKETS = 4;
+	static constexpr size_t BUCKETS = 32 * SUB_BUCKETS;
+
+private:
+	std::array<uint64_t, BUCKETS> _buckets;
+	uint64_t _count;
+	Nsec _sum;
+	Nsec _min;
+	Nsec _max;
+
+public:
+	LatencyHistogram();
+	~LatencyHistogram();
+
+	LatencyHistogram & add(Nsec latency);
+	LatencyHistogram & reset();
+
+	[[nodiscard]] uint64_t count() const;
+	[[nodiscard]] Nsec min() const;
+	[[nodiscard]] Nsec max() const;
+	[[nodiscard]] Nsec mean() const;
+	[[nodiscard]] Nsec percentile(double p) const;
+	[[nodiscard]] Nsec p50() const;
+	[[nodiscard]] Nsec p99() const;
+	[[nodiscard]] const std::array<uint64_t, BUCKETS> & buckets() const;
+
+	[[nodiscard]] static Nsec bucket_lower(size_t bucket);
+	[[nodiscard]] static Nsec bucket_upper(size_t bucket);
+
+private:
+	static size_t _bucket(Nsec latency);
+};
+
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+
+namespace wlkit {
+
+// most recently used first. nodes are linked by index inside one vector and reused through a free list,
+// so moving a known item to the front never allocates. with a capacity the least recent item is dropped
+template <typename T>
+class History {
+private:
+	static constexpr uint32_t NIL = UINT32_MAX;
+
+	typedef struct {
+		T item;
+		uint32_t prev;
+		uint32_t next;
+	} Node;
+
+public:
+	class ConstIterator {
+	private:
+		const History * _history;
+		uint32_t _node;
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T *;
+		using reference = const T &;
+
+		ConstIterator():
+		_history(nullptr), _node(NIL) {}
+
+		ConstIterator(const History * history, uint32_t node):
+		_history(history), _node(node) {}
+
+		reference operator*() const {
+			return _history->_nodes[_node].item;
+		}
+
+		pointer operator->() const {
+			return &_history->_nodes[_node].item;
+		}
+
+		ConstIterator & operator++() {
+			_node = _history->_nodes[_node].next;
+			return *this;
+		}
+
+		ConstIterator operator++(int) {
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		// end() steps back to the least recent item
+		ConstIterator & operator--() {
+			_node = _node == NIL ? _history->_tail : _history->_nodes[_node].prev;
+			return *this;
+		}
+
+		ConstIterator operator--(int) {
+			auto it = *this;
+			--*this;
+			return it;
+		}
+
+		bool operator==(const ConstIterator & other) const {
+			return _node == other._node;
+		}
+	};
+
+	using Iterator = ConstIterator;
+	using ReverseIterator = std::reverse_iterator<ConstIterator>;
+
+private:
+	std::vector<Node> _nodes;
+	std::unordered_map<T, uint32_t> _index;
+	uint32_t _head, _tail, _free;
+	size_t _capacity;
+
+public:
+	explicit History(size_t capacity = 0):
+	_head(NIL), _tail(NIL), _free(NIL), _capacity(0) {
+		set_capacity(capacity);
+	}
+
+	// moves the item to the front, a new item is added there
+	History & shift(const T & item) {
+		auto it = _index.find(item);
+		if (it != _index.end()) {
+			_unlink(it->second);
+			_link_front(it->second);
+			return *this;
+		}
+
+		if (_capacity > 0 && _index.size() >= _capacity) {
+			remove(_nodes[_tail].item);
+		}
+		uint32_t node = _alloc(item);
+		_index.emplace(item, node);
+		_link_front(node);
+		return *this;
+	}
+
+	// adds the item as the least recent one, a known item keeps its place
+	History & push_back(const T & item) {
+		if (_index.contains(item) || (_capacity > 0 && _index.size() >= _capacity)) {
+			return *this;
+		}
+
+		uint32_t node = _alloc(item);
+		_index.emplace(item, node);
+		_link_back(node);
+		return *this;
+	}
+
+	History & remove(const T & item) {
+		auto it = _index.find(item);
+		if (it == _index.end()) {
+			return *this;
+		}
+
+		uint32_t node = it->second;
+		_index.erase(it);
+		_unlink(node);
+		_nodes[node].item = T{};
+		_nodes[node].next = _free;
+		_free = node;
+		return *this;
+	}
+
+	History & clear() {
+		_nodes.clear();
+		_index.clear();
+		_head = _tail = _free = NIL;
+		return *this;
+	}
+
+	// 0 is unbounded, shrinking drops the least recent items
+	History & set_capacity(size_t capacity) {
+		_capacity = capacity;
+		while (_capacity > 0 && _index.size() > _capacity) {
+			remove(_nodes[_tail].item);
+		}
+		if (_capacity > 0) {
+			_nodes.reserve(_capacity);
+			_index.reserve(_capacity);
+		}
+		return *this;
+	}
+
+	[[nodiscard]] const History & history() const {
+		return *this;
+	}
+
+	[[nodiscard]] T top() const {
+		return _head == NIL ? T{} : _nodes[_head].item;
+	}
+
+	[[nodiscard]] T previous() const {
+		if (_head == NIL || _nodes[_head].next == NIL) {
+			return T{};
+		}
+		return _nodes[_nodes[_head].next].item;
+	}
+
+	[[nodiscard]] bool contains(const T & item) const {
+		return _index.contains(item);
+	}
+
+	[[nodiscard]] bool empty() const {
+		return _index.empty();
+	}
+
+	[[nodiscard]] size_t size() const {
+		return _index.size();
+	}
+
+	[[nodiscard]] size_t capacity() const {
+		return _capacity;
+	}
+
+	ConstIterator begin() const {
+		return { this, _head };
+	}
+
+	ConstIterator end() const {
+		return { this, NIL };
+	}
+
+	ConstIterator cbegin() const {
+		return begin();
+	}
+
+	ConstIterator cend() const {
+		return end();
+	}
+
+	ReverseIterator rbegin() const {
+		return ReverseIterator(end());
+	}
+
+	ReverseIterator rend() const {
+		return ReverseIterator(begin());
+	}
+
+private:
+	uint32_t _alloc(const T & item) {
+		if (_free != NIL) {
+			uint32_t node = _free;
+			_free = _nodes[node].next;
+			_nodes[node] = { item, NIL, NIL };
+			return node;
+		}
+
+		_nodes.push_back({ item, NIL, NIL });
+		return static_cast<uint32_t>(_nodes.size() - 1);
+	}
+
+	void _unlink(uint32_t node) {
+		auto & n = _nodes[node];
+		if (n.prev != NIL) {
+			_nodes[n.prev].next = n.next;
+		} else {
+			_head = n.next;
+		}
+		if (n.next != NIL) {
+			_nodes[n.next].prev = n.prev;
+		} else {
+			_tail = n.prev;
+		}
+		n.prev = n.next = NIL;
+	}
+
+	void _link_front(uint32_t node) {
+		_nodes[node].prev = NIL;
+		_nodes[node].next = _head;
+		if (_head != NIL) {
+			_nodes[_head].prev = node;
+		} else {
+			_tail = node;
+		}
+		_head = node;
+	}
+
+	void _link_back(uint32_t node) {
+		_nodes[node].next = NIL;
+		_nodes[node].prev = _tail;
+		if (_tail != NIL) {
+			_nodes[_tail].next = node;
+		} else {
+			_head = node;
+		}
+		_tail = node;
+	}
+};
+
+}
@@ -5,6 +5,8 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
+#include "histogram.hpp"
 
 namespace wlkit {
 
@@ -25,11 +27,13 @@ protected:
 	Server * _server;
 	const Type _type;
 	struct ::wlr_input_device * _device;
+	Nsec _last_event;
+	LatencyHistogram * _latency;
 
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Input::on_create"};
+	HandlerList<Handler> _on_destroy{"Input::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -51,13 +55,17 @@ public:
 	[[nodiscard]] Server * server() const;
 	[[nodiscard]] Type type() const;
 	[[nodiscard]] struct ::wlr_input_device * device() const;
+	[[nodiscard]] Nsec last_event() const;
+	[[nodiscard]] LatencyHistogram * latency() const;
 	[[nodiscard]] void * data() const;
 
 	Input & set_data(void * data);
 
-	Input & on_destroy(const Handler & handler);
+	Input & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 protected:
+	void _stamp();
+
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "handler_list.hpp"
 
 namespace wlkit {
 
@@ -12,8 +13,8 @@ private:
 	char * _name;
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Layout::on_create"};
+	HandlerList<Handler> _on_destroy{"Layout::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -33,7 +34,7 @@ public:
 
 	Layout & set_data(void * data);
 
-	Layout & on_destroy(const Handler & handler);
+	Layout & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
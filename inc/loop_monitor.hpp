@@ -0,0 +1,55 @@
+#pragma once
+
+#include "common.hpp"
+#include "handler_list.hpp"
+#include "histogram.hpp"
+
+namespace wlkit {
+
+class LoopMonitor {
+public:
+	using StallHandler = std::function<void(LoopMonitor * monitor, Nsec duration)>;
+
+	static constexpr Nsec DEFAULT_STALL_THRESHOLD = 8000000;
+
+private:
+	Server * _server;
+	Nsec _stall_threshold;
+	uint64_t _wakeups;
+	uint64_t _events;
+	uint64_t _max_events;
+	uint64_t _stalls;
+	uint64_t _timers;
+	Nsec _busy;
+	Nsec _started;
+	LatencyHistogram _dispatch;
+	LatencyHistogram _timer_lag;
+
+	HandlerList<StallHandler> _on_stall{"LoopMonitor::on_stall"};
+
+public:
+	LoopMonitor(Server * server);
+	~LoopMonitor();
+
+	bool run();
+	LoopMonitor & record_timer(Nsec deadline);
+	LoopMonitor & reset();
+
+	[[nodiscard]] Server * server() const;
+	[[nodiscard]] Nsec stall_threshold() const;
+	[[nodiscard]] uint64_t wakeups() const;
+	[[nodiscard]] uint64_t events() const;
+	[[nodiscard]] uint64_t max_events() const;
+	[[nodiscard]] double events_per_wakeup() const;
+	[[nodiscard]] uint64_t stalls() const;
+	[[nodiscard]] uint64_t timers() const;
+	[[nodiscard]] double load() const;
+	[[nodiscard]] const LatencyHistogram & dispatch() const;
+	[[nodiscard]] const LatencyHistogram & timer_lag() const;
+
+	LoopMonitor & set_stall_threshold(Nsec threshold);
+
+	LoopMonitor & on_stall(const StallHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "handler_list.hpp"
 
 namespace wlkit {
 
@@ -29,8 +30,8 @@ private:
 	ID _id;
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Node::on_create"};
+	HandlerList<Handler> _on_destroy{"Node::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -50,7 +51,7 @@ public:
 
 	Node & set_data(void * data);
 
-	Root & on_destroy(const Handler & handler);
+	Root & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 	static struct ::wlr_scene_tree * alloc_scene_tree(struct ::wlr_scene_tree * parent, bool * failed);
 
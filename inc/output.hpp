@@ -1,12 +1,21 @@
 #pragma once
 
+#include <array>
 #include <ctime>
+#include <vector>
 
 extern "C" {
 #include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_damage_ring.h>
+#include <wlr/types/wlr_output_layer.h>
+#include <wlr/util/box.h>
+#include <wlr/util/transform.h>
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
+#include "histogram.hpp"
+#include "workspace.hpp"
 
 namespace wlkit {
 
@@ -29,6 +38,23 @@ public:
 	using GammaLUTRampSize = size_t;
 	using GammaLUTComponent = uint16_t;
 	using CommitSeq = uint32_t;
+	using MaxRenderTime = int32_t;
+	using BudgetShare = double;
+
+	static constexpr MaxRenderTime MAX_RENDER_TIME_OFF = 0;
+	static constexpr MaxRenderTime MAX_RENDER_TIME_AUTO = -1;
+	// an input nothing reacted to within this many refresh intervals is not a latency sample
+	static constexpr uint32_t INPUT_LATENCY_FRAMES = 6;
+
+	enum class RenderMode {
+		CUSTOM,
+		SCENE,
+	};
+
+	enum class FramePacing {
+		FIXED,
+		ADAPTIVE,
+	};
 
 	using State = struct {
 		bool enabled;
@@ -53,6 +79,12 @@ public:
 		ModeRefresh refresh;
 	} Mode;
 
+	typedef struct {
+		Input * input;
+		Nsec time;
+		CommitSeq commit_seq;
+	} InputSample;
+
 	typedef struct {
 		GammaLUTRampSize ramp_size;
 		GammaLUTComponent r;
@@ -67,20 +99,59 @@ private:
 	struct ::wlr_scene_output * _scene_output;
 	struct ::wlr_output_state * _state;
 	struct ::wl_event_source * _repaint_timer;
+	struct ::wl_event_source * _lfc_timer;
+	Nsec _repaint_deadline;
+	Nsec _lfc_deadline;
+	struct ::wlr_damage_ring _damage_ring;
+	Render * _render;
 
 	Geo _x, _y;
+	RenderMode _render_mode;
+	MaxRenderTime _max_render_time;
+	bool _direct_scanout;
+	bool _scanned_out;
+	bool _frame_requested;
+	bool _repaint_scheduled;
+	bool _layer_offload;
+	OutputLayers * _layers;
+	FramePacing _frame_pacing;
+	ModeRefresh _vrr_min_refresh;
+	ModeRefresh _vrr_max_refresh;
+	Nsec _last_content_commit;
+	Nsec _content_interval;
 	struct timespec _last_frame;
+	struct timespec _last_presentation;
+	Nsec _refresh_nsec;
+	std::array<Nsec, 16> _render_durations;
+	size_t _n_render_durations;
+	size_t _render_durations_head;
 	Workspace * _current_workspace;
-	std::list<Workspace*> _workspaces;
+	DenseSet<Workspace*> _workspaces;
 	WorkspacesHistory * _workspaces_history;
+	FrameStats * _frame_stats;
+	std::vector<InputSample> _pending_inputs;
+	std::vector<InputSample> _tagged_inputs;
+	LatencyHistogram * _input_latency;
+	BudgetShare _budget_share;
+	uint32_t _budget_frames;
+	uint32_t _over_budget;
+	uint32_t _within_budget;
+	bool _auto_degrade;
+	bool _degraded;
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	std::list<FrameHandler> _on_frame;
+	HandlerList<Handler> _on_create{"Output::on_create"};
+	HandlerList<Handler> _on_destroy{"Output::on_destroy"};
+	HandlerList<FrameHandler> _on_frame{"Output::on_frame"};
+	HandlerList<FrameHandler> _on_frame_effect{"Output::on_frame_effect"};
+	HandlerList<Handler> _on_over_budget{"Output::on_over_budget"};
+	HandlerList<Handler> _on_degrade{"Output::on_degrade"};
 
 	struct wl_listener _destroy_listener;
 	struct wl_listener _frame_listener;
+	struct wl_listener _present_listener;
+	struct wl_listener _needs_frame_listener;
+	struct wl_listener _damage_listener;
 
 public:
 	Output(
@@ -94,20 +165,53 @@ public:
 	Output & setup_preferred_mode();
 	Output & setup_gamma_lut(const GammaLUT * gamma_lut);
 	Output & commit_state();
+	Output & damage_box(const struct ::wlr_box * box);
+	Output & damage_buffer_box(const struct ::wlr_box * box);
+	Output & damage_region(const pixman_region32_t * region);
+	Output & damage_whole();
+	Output & schedule_frame();
+	Output & request_redraw();
+	Output & add_input(Input * input, Nsec time);
+	Output & forget_input(Input * input);
 	// Output & switch_workspace(Workspace::ID id);
-	Window * window_at(Geo x, Geo y);
+	bool hit_test(Geo lx, Geo ly, WindowGrid::Hit * hit);
+	Window * window_at(Geo lx, Geo ly);
+	[[nodiscard]] struct ::wlr_box buffer_box(const struct ::wlr_box * box) const;
 
 	[[nodiscard]] Server * server() const;
 	[[nodiscard]] struct ::wlr_output * wlr_output() const;
 	[[nodiscard]] struct ::wlr_scene_output * scene_output() const;
 	[[nodiscard]] struct ::wl_event_source * repaint_timer() const;
 	[[nodiscard]] struct ::wlr_output_state * state() const;
+	[[nodiscard]] Render * render() const;
+	[[nodiscard]] struct ::wlr_damage_ring * damage_ring();
+	[[nodiscard]] bool has_damage() const;
 	[[nodiscard]] Geo x() const;
 	[[nodiscard]] Geo y() const;
+	[[nodiscard]] RenderMode render_mode() const;
+	[[nodiscard]] MaxRenderTime max_render_time() const;
+	[[nodiscard]] MaxRenderTime render_budget() const;
+	[[nodiscard]] bool direct_scanout() const;
+	[[nodiscard]] bool scanned_out() const;
+	[[nodiscard]] bool tearing() const;
+	[[nodiscard]] bool layer_offload() const;
+	[[nodiscard]] OutputLayers * layers() const;
+	[[nodiscard]] FramePacing frame_pacing() const;
+	[[nodiscard]] bool adaptive_pacing() const;
+	[[nodiscard]] ModeRefresh vrr_min_refresh() const;
+	[[nodiscard]] ModeRefresh vrr_max_refresh() const;
+	[[nodiscard]] Nsec content_interval() const;
 	[[nodiscard]] struct timespec last_frame() const;
+	[[nodiscard]] struct timespec last_presentation() const;
 	[[nodiscard]] Workspace * current_workspace() const;
-	[[nodiscard]] std::list<Workspace*> workspaces() const;
+	[[nodiscard]] std::span<Workspace * const> workspaces() const;
 	[[nodiscard]] WorkspacesHistory * workspaces_history() const;
+	[[nodiscard]] FrameStats * frame_stats() const;
+	[[nodiscard]] LatencyHistogram * input_latency() const;
+	[[nodiscard]] BudgetShare budget_share() const;
+	[[nodiscard]] uint32_t budget_frames() const;
+	[[nodiscard]] bool auto_degrade() const;
+	[[nodiscard]] bool degraded() const;
 	[[nodiscard]] void * data() const;
 
 	[[nodiscard]] const char * name() const;
@@ -133,18 +237,49 @@ public:
 	[[nodiscard]] CommitSeq commit_seq() const;
 
 	Output & switch_to_workspace(Workspace * workspace);
+	Output & remove_workspace(Workspace * workspace);
 
 	Output & set_x(Geo x);
 	Output & set_y(Geo y);
+	Output & set_render_mode(RenderMode mode);
+	Output & set_max_render_time(MaxRenderTime msec);
+	Output & set_direct_scanout(bool enabled);
+	Output & set_layer_offload(bool enabled);
+	Output & set_frame_pacing(FramePacing pacing);
+	Output & set_vrr_range(ModeRefresh min_refresh, ModeRefresh max_refresh);
+	Output & set_frame_budget(BudgetShare share, uint32_t frames);
+	Output & set_auto_degrade(bool enabled);
+	Output & set_degraded(bool degraded);
 	// TODO setters
 
-	Output & on_destroy(const Handler & handler);
-	Output & on_frame(const FrameHandler & handler);
+	Output & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Output & on_frame(const FrameHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Output & on_frame_effect(const FrameHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Output & on_over_budget(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Output & on_degrade(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
+	void _repaint();
+	bool _try_direct_scanout(bool tearing);
+	bool _commit_scene(bool tearing, bool force);
+	bool _repeat_frame();
+	void _frame_committed(bool repeat = false);
+	void _update_thumbnails();
+	void _send_frame_done();
+	void _sample_windows(Window * scanned_out);
+	void _record_render_duration(Nsec duration);
+	void _tag_inputs();
+	Nsec _input_cutoff() const;
+	void _check_frame_budget(Nsec spent);
+	void _record_input_latency(CommitSeq commit_seq, Nsec when);
+
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 	static void _handle_frame(struct ::wl_listener * listener, void * data);
+	static void _handle_present(struct ::wl_listener * listener, void * data);
+	static void _handle_needs_frame(struct ::wl_listener * listener, void * data);
+	static void _handle_damage(struct ::wl_listener * listener, void * data);
 	static int _handle_repaint_timer(void * data);
+	static int _handle_lfc_timer(void * data);
 };
 
 class OutputStateBuilder {
@@ -170,4 +305,99 @@ public:
 	std::unique_ptr<Output::State> build();
 };
 
+class OutputLayers {
+private:
+	struct Entry {
+		OutputLayers * layers;
+		struct ::wlr_surface * surface;
+		struct ::wlr_output_layer * layer;
+		struct ::wlr_box box;
+		struct ::wlr_fbox src_box;
+		bool used;
+		bool accepted;
+		struct ::wl_listener commit_listener;
+		struct ::wl_listener destroy_listener;
+	};
+
+	Output * _output;
+	std::list<Entry> _entries;
+	std::vector<struct ::wlr_output_layer_state> _states;
+
+public:
+	OutputLayers(Output * output);
+	~OutputLayers();
+
+	OutputLayers & collect(Window * window);
+	OutputLayers & apply(struct ::wlr_output_state * state);
+	OutputLayers & update_accepted();
+	OutputLayers & sample();
+	OutputLayers & clear();
+
+	[[nodiscard]] bool empty() const;
+	[[nodiscard]] bool all_accepted() const;
+	[[nodiscard]] bool is_offloaded(struct ::wlr_surface * surface) const;
+
+private:
+	void _remove(Entry * entry);
+
+	static void _handle_commit(struct ::wl_listener * listener, void * data);
+	static void _handle_destroy(struct ::wl_listener * listener, void * data);
+};
+
+class FrameStats {
+public:
+	static constexpr size_t CAPACITY = 256;
+
+	typedef struct {
+		Output::CommitSeq commit_seq;
+		Nsec vblank;
+		Nsec handler;
+		Nsec submit;
+		Nsec commit;
+		Nsec present;
+		bool presented;
+		bool discarded;
+	} Frame;
+
+	enum class Metric {
+		HANDLER,
+		SUBMIT,
+		COMMIT,
+		LATENCY,
+		INTERVAL,
+	};
+
+private:
+	std::array<Frame, CAPACITY> _frames;
+	size_t _head;
+	size_t _size;
+	Nsec _refresh;
+	Nsec _measured_refresh;
+	Nsec _last_present;
+	uint64_t _n_frames;
+	uint64_t _n_presented;
+	uint64_t _missed_vblanks;
+
+public:
+	FrameStats();
+	~FrameStats();
+
+	FrameStats & record(const Frame & frame);
+	FrameStats & record_present(Output::CommitSeq commit_seq, Nsec when, Nsec refresh, bool presented);
+	FrameStats & reset();
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] const Frame & frame(size_t age) const;
+	[[nodiscard]] Nsec percentile(Metric metric, double p) const;
+	[[nodiscard]] Nsec p50(Metric metric) const;
+	[[nodiscard]] Nsec p99(Metric metric) const;
+	[[nodiscard]] Nsec refresh_interval() const;
+	[[nodiscard]] uint64_t frames() const;
+	[[nodiscard]] uint64_t presented() const;
+	[[nodiscard]] uint64_t missed_vblanks() const;
+
+private:
+	Frame * _find(Output::CommitSeq commit_seq);
+};
+
 }
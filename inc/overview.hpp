@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+extern "C" {
+#include <wlr/util/box.h>
+}
+
+#include "common.hpp"
+#include "handler_list.hpp"
+
+namespace wlkit {
+
+class Overview {
+public:
+	using Handler = std::function<void(Overview*)>;
+	using WindowHandler = std::function<void(Overview*, Window*)>;
+
+	typedef struct {
+		Window * window;
+		struct wlr_box box;
+	} Cell;
+
+private:
+	Output * _output;
+	bool _active;
+	int _gap;
+	Window * _selected;
+	std::vector<Cell> _cells;
+
+	void * _data;
+
+	HandlerList<Handler> _on_create{"Overview::on_create"};
+	HandlerList<Handler> _on_destroy{"Overview::on_destroy"};
+	HandlerList<Handler> _on_show{"Overview::on_show"};
+	HandlerList<Handler> _on_hide{"Overview::on_hide"};
+	HandlerList<WindowHandler> _on_activate{"Overview::on_activate"};
+
+public:
+	Overview(
+		Output * output,
+		const Handler & callback);
+	~Overview();
+
+	Overview & show();
+	Overview & hide();
+	Overview & toggle();
+	Overview & select(Window * window);
+	Overview & select_next();
+	Overview & select_prev();
+	Overview & activate();
+	Overview & draw(Render * render);
+
+	[[nodiscard]] Output * output() const;
+	[[nodiscard]] bool active() const;
+	[[nodiscard]] int gap() const;
+	[[nodiscard]] Window * selected() const;
+	[[nodiscard]] Window * window_at(Geo x, Geo y) const;
+	[[nodiscard]] const std::vector<Cell> & cells() const;
+	[[nodiscard]] void * data() const;
+
+	Overview & set_gap(int gap);
+	Overview & set_data(void * data);
+
+	Overview & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Overview & on_show(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Overview & on_hide(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Overview & on_activate(const WindowHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+
+private:
+	void _collect();
+	void _arrange();
+};
+
+}
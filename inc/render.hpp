@@ -1,11 +1,19 @@
 #pragma once
 
+#include <span>
+#include <vector>
+
 extern "C" {
 #include <wlr/types/wlr_output.h>
 #include <wlr/render/pass.h>
+#include <wlr/render/drm_syncobj.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/util/box.h>
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
 
 namespace wlkit {
 
@@ -16,35 +24,119 @@ public:
 private:
 	Output * _output;
 
-	struct ::wlr_output_state * _state;
+	struct ::wlr_output_state _state;
 	struct ::wlr_render_pass * _pass;
+	struct ::wlr_buffer * _buffer;
+	struct ::wlr_render_timer * _timer;
+	struct ::wlr_drm_syncobj_timeline * _timeline;
+	uint64_t _timeline_point;
+	bool _timer_pending;
+	Nsec _gpu_duration;
+	Nsec _submit_duration;
+	Nsec _commit_duration;
+	bool _committed;
+	pixman_region32_t _frame_damage;
+	pixman_region32_t _buffer_damage;
 
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Render::on_create"};
+	HandlerList<Handler> _on_destroy{"Render::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
 public:
 	Render(
 		Output * output,
-		struct ::wlr_buffer_pass_options * pass_opts,
 		const Handler & callback);
 	~Render();
 
+	bool begin(struct ::wlr_buffer_pass_options * pass_opts);
+	Render & draw(DisplayList & list);
+	Render & draw_rect(struct ::wlr_render_rect_options opts);
+	Render & draw_texture(struct ::wlr_render_texture_options opts);
+	Render & draw_surface(struct ::wlr_surface * surface, struct ::wlr_render_texture_options opts);
 	Render & commit();
 
 	[[nodiscard]] Output * output() const;
-	[[nodiscard]] struct ::wlr_output_state * state() const;
+	[[nodiscard]] struct ::wlr_output_state * state();
 	[[nodiscard]] struct ::wlr_render_pass * pass() const;
+	[[nodiscard]] struct ::wlr_buffer * buffer() const;
+	[[nodiscard]] const pixman_region32_t * damage() const;
+	[[nodiscard]] Nsec gpu_duration() const;
+	[[nodiscard]] Nsec submit_duration() const;
+	[[nodiscard]] Nsec commit_duration() const;
+	[[nodiscard]] bool committed() const;
+	[[nodiscard]] bool is_offloaded(struct ::wlr_surface * surface) const;
+	[[nodiscard]] bool is_damaged(const struct ::wlr_box & box) const;
+	[[nodiscard]] struct ::wlr_drm_syncobj_timeline * timeline() const;
+	[[nodiscard]] uint64_t timeline_point() const;
+
+	static void wait_for_surface(struct ::wlr_surface * surface, struct ::wlr_render_texture_options * opts);
 
 	// TODO setters
 
-	Render & on_destroy(const Handler & handler);
+	Render & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
+	bool _clip(const struct ::wlr_box & box, const pixman_region32_t ** clip) const;
+
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 };
 
+class DisplayList {
+public:
+	typedef struct {
+		struct ::wlr_box box;
+		struct ::wlr_render_color color;
+	} Rect;
+
+	typedef struct {
+		struct ::wlr_texture * texture;
+		struct ::wlr_fbox src_box;
+		struct ::wlr_box dst_box;
+		float alpha;
+		enum ::wl_output_transform transform;
+	} Texture;
+
+private:
+	enum class Kind {
+		RECT,
+		TEXTURE,
+	};
+
+	typedef struct {
+		Kind kind;
+		size_t index;
+	} Item;
+
+	std::vector<Rect> _rects;
+	std::vector<Texture> _textures;
+	std::vector<Item> _items;
+
+	std::vector<struct ::wlr_render_rect_options> _compiled_rects;
+	std::vector<struct ::wlr_render_texture_options> _compiled_textures;
+	std::vector<Item> _compiled;
+	int _compiled_width, _compiled_height;
+	bool _dirty;
+
+public:
+	DisplayList();
+	~DisplayList();
+
+	DisplayList & clear();
+	DisplayList & add_rect(const struct ::wlr_box & box, const struct ::wlr_render_color & color);
+	DisplayList & add_rects(std::span<const Rect> rects);
+	DisplayList & add_texture(const Texture & texture);
+	DisplayList & add_textures(std::span<const Texture> textures);
+	DisplayList & submit(struct ::wlr_render_pass * pass, int width, int height, const pixman_region32_t * clip = nullptr);
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] size_t compiled_size() const;
+	[[nodiscard]] bool dirty() const;
+
+private:
+	void _compile(int width, int height);
+};
+
 }
@@ -5,6 +5,7 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
 #include "cursor.hpp"
 
 namespace wlkit {
@@ -19,6 +20,7 @@ private:
 	struct ::wlr_scene * _scene;
 	struct ::wlr_output_layout * _output_layout;
 	struct ::wlr_scene_tree * _staging;
+	struct ::wlr_scene_tree * _workspace_tree;
 	struct ::wlr_scene_tree * _layer_tree;
 
 	Geo _x, _y, _width, _height;
@@ -28,8 +30,8 @@ private:
 
 	// struct ::wl_list layers;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
+	HandlerList<Handler> _on_create{"Root::on_create"};
+	HandlerList<Handler> _on_destroy{"Root::on_destroy"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -44,13 +46,15 @@ public:
 	[[nodiscard]] struct ::wlr_scene * scene() const;
 	[[nodiscard]] struct ::wlr_output_layout * output_layout() const;
 	[[nodiscard]] struct ::wlr_scene_tree * staging() const;
+	[[nodiscard]] struct ::wlr_scene_tree * workspace_tree() const;
 	[[nodiscard]] struct ::wlr_scene_tree * layer_tree() const;
 	[[nodiscard]] Geo x() const;
 	[[nodiscard]] Geo y() const;
 	[[nodiscard]] Geo width() const;
 	[[nodiscard]] Geo height() const;
+	[[nodiscard]] Cursor * cursor() const;
 
-	Root & on_destroy(const Handler & handler);
+	Root & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
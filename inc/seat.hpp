@@ -5,6 +5,7 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
 #include "device/pointer.hpp"
 #include "device/keyboard.hpp"
 
@@ -34,21 +35,21 @@ private:
 	struct ::wlr_seat * _wlr_seat;
 	struct ::wlr_seat_client * _wlr_seat_client;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	std::list<Handler> _on_pointer_grab_begin;
-	std::list<Handler> _on_pointer_grab_end;
-	std::list<Handler> _on_keyboard_grab_begin;
-	std::list<Handler> _on_keyboard_grab_end;
-	std::list<Handler> _on_touch_grab_begin;
-	std::list<Handler> _on_touch_grab_end;
-	std::list<RequestSetCursorHandler> _on_request_set_cursor;
-	std::list<RequestSetSelectionHandler> _on_request_set_selection;
-	std::list<Handler> _on_set_selection;
-	std::list<RequestSetPrimarySelectionHandler> _on_request_set_primary_selection;
-	std::list<Handler> _on_set_primary_selection;
-	std::list<RequestStartDragHandler> _on_request_start_drag;
-	std::list<StartDragHandler> _on_start_drag;
+	HandlerList<Handler> _on_create{"Seat::on_create"};
+	HandlerList<Handler> _on_destroy{"Seat::on_destroy"};
+	HandlerList<Handler> _on_pointer_grab_begin{"Seat::on_pointer_grab_begin"};
+	HandlerList<Handler> _on_pointer_grab_end{"Seat::on_pointer_grab_end"};
+	HandlerList<Handler> _on_keyboard_grab_begin{"Seat::on_keyboard_grab_begin"};
+	HandlerList<Handler> _on_keyboard_grab_end{"Seat::on_keyboard_grab_end"};
+	HandlerList<Handler> _on_touch_grab_begin{"Seat::on_touch_grab_begin"};
+	HandlerList<Handler> _on_touch_grab_end{"Seat::on_touch_grab_end"};
+	HandlerList<RequestSetCursorHandler> _on_request_set_cursor{"Seat::on_request_set_cursor"};
+	HandlerList<RequestSetSelectionHandler> _on_request_set_selection{"Seat::on_request_set_selection"};
+	HandlerList<Handler> _on_set_selection{"Seat::on_set_selection"};
+	HandlerList<RequestSetPrimarySelectionHandler> _on_request_set_primary_selection{"Seat::on_request_set_primary_selection"};
+	HandlerList<Handler> _on_set_primary_selection{"Seat::on_set_primary_selection"};
+	HandlerList<RequestStartDragHandler> _on_request_start_drag{"Seat::on_request_start_drag"};
+	HandlerList<StartDragHandler> _on_start_drag{"Seat::on_start_drag"};
 
 	struct ::wl_listener _destroy_listener;
 	struct ::wl_listener _pointer_grab_begin_listener;
@@ -119,20 +120,20 @@ public:
 	[[nodiscard]] struct ::wlr_seat * wlr_seat() const;
 	[[nodiscard]] struct ::wlr_seat_client * wlr_seat_client() const;
 
-	Seat & on_destroy(const Handler & handler);
-	Seat & on_pointer_grab_begin(const Handler & handler);
-	Seat & on_pointer_grab_end(const Handler & handler);
-	Seat & on_keyboard_grab_begin(const Handler & handler);
-	Seat & on_keyboard_grab_end(const Handler & handler);
-	Seat & on_touch_grab_begin(const Handler & handler);
-	Seat & on_touch_grab_end(const Handler & handler);
-	Seat & on_request_set_cursor(const RequestSetCursorHandler & handler);
-	Seat & on_request_set_selection(const RequestSetSelectionHandler & handler);
-	Seat & on_set_selection(const Handler & handler);
-	Seat & on_request_set_primary_selection(const RequestSetPrimarySelectionHandler & handler);
-	Seat & on_set_primary_selection(const Handler & handler);
-	Seat & on_request_start_drag(const RequestStartDragHandler & handler);
-	Seat & on_start_drag(const StartDragHandler & handler);
+	Seat & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_pointer_grab_begin(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_pointer_grab_end(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_keyboard_grab_begin(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_keyboard_grab_end(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_touch_grab_begin(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_touch_grab_end(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_request_set_cursor(const RequestSetCursorHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_request_set_selection(const RequestSetSelectionHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_set_selection(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_request_set_primary_selection(const RequestSetPrimarySelectionHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_set_primary_selection(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_request_start_drag(const RequestStartDragHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Seat & on_start_drag(const StartDragHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
@@ -39,9 +39,15 @@ extern "C" {
 #include <wlr/types/wlr_server_decoration.h>
 #include <wlr/types/wlr_xdg_decoration_v1.h>
 #include <wlr/types/wlr_ext_image_capture_source_v1.h>
+#include <wlr/types/wlr_tearing_control_v1.h>
+#include <wlr/types/wlr_presentation_time.h>
+#include <wlr/types/wlr_linux_drm_syncobj_v1.h>
 }
 
 #include "common.hpp"
+#include "dense_set.hpp"
+#include "handler_list.hpp"
+#include "loop_monitor.hpp"
 #include "seat.hpp"
 #include "workspace.hpp"
 
@@ -71,14 +77,16 @@ private:
 	struct ::wlr_compositor * _compositor;
 
 	Root * _root;
+	LoopMonitor * _loop_monitor;
 	const char * _socket_id;
 	bool _inside_wl;
 	bool _running;
 	Output * _preferred_output;
-	std::list<Output*> _outputs;
-	std::list<Input*> _inputs;
-	std::list<Workspace*> _workspaces;
-	std::list<Window*> _windows;
+	DenseSet<Output*> _outputs;
+	DenseSet<Input*> _inputs;
+	DenseSet<Workspace*> _workspaces;
+	DenseSet<Window*> _windows;
+	std::unordered_map<Workspace::ID, Workspace*> _workspaces_by_id;
 	WindowsHistory * _windows_history;
 	// struct ::wl_list _decorations;
 	// struct ::wl_list _xdg_decorations;
@@ -115,17 +123,19 @@ private:
 	// struct wlr_ext_image_copy_capture_manager_v1 * ext_image_copy_capture_manager_v1;
 	// struct wlr_output_power_manager_v1 * output_power_manager_v1;
 	// struct wlr_tablet_manager_v2 * tablet_manager_v2;
-	// struct wlr_tearing_control_manager_v1 * tearing_control_manager_v1;
-
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	std::list<Handler> _on_start;
-	std::list<Handler> _on_stop;
-	std::list<OutputLayoutChangeHandler> _on_output_layout_change;
-	std::list<NewOutputHandler> _on_new_output;
-	std::list<NewInputHandler> _on_new_input;
-	std::list<NewSurfaceHandler> _on_new_xdg_shell_toplevel;
-	std::list<NewSurfaceHandler> _on_new_xdg_shell_popup;
+	struct ::wlr_tearing_control_manager_v1 * _tearing_control_manager;
+	struct ::wlr_presentation * _presentation;
+	struct ::wlr_linux_drm_syncobj_manager_v1 * _drm_syncobj_manager;
+
+	HandlerList<Handler> _on_create{"Server::on_create"};
+	HandlerList<Handler> _on_destroy{"Server::on_destroy"};
+	HandlerList<Handler> _on_start{"Server::on_start"};
+	HandlerList<Handler> _on_stop{"Server::on_stop"};
+	HandlerList<OutputLayoutChangeHandler> _on_output_layout_change{"Server::on_output_layout_change"};
+	HandlerList<NewOutputHandler> _on_new_output{"Server::on_new_output"};
+	HandlerList<NewInputHandler> _on_new_input{"Server::on_new_input"};
+	HandlerList<NewSurfaceHandler> _on_new_xdg_shell_toplevel{"Server::on_new_xdg_shell_toplevel"};
+	HandlerList<NewSurfaceHandler> _on_new_xdg_shell_popup{"Server::on_new_xdg_shell_popup"};
 
 	struct ::wl_listener _destroy_listener;
 	struct ::wl_listener _output_layout_change_listener;
@@ -151,7 +161,8 @@ private:
 public:
 	Server(
 		Seat * seat,
-		const Handler & callback = nullptr);
+		const Handler & callback = nullptr,
+		const char * backends = nullptr);
 
 	~Server();
 
@@ -163,6 +174,8 @@ public:
 	Server & add_window(Window * window);
 	Server & remove_workspace(Workspace * workspace);
 	Server & remove_window(Window * window);
+	Server & remove_output(Output * output);
+	Server & remove_input(Input * input);
 	Server & prefer_output(Output * output);
 
 	[[nodiscard]] struct ::wl_display * display() const;
@@ -181,25 +194,31 @@ public:
 	[[nodiscard]] Output * preferred_output() const;
 	[[nodiscard]] void * data() const;
 
-	[[nodiscard]] std::list<Output*> outputs() const;
-	[[nodiscard]] std::list<Input*> inputs() const;
-	[[nodiscard]] std::list<Workspace*> workspaces() const;
-	[[nodiscard]] std::list<Window*> windows() const;
+	// views over the live sets, invalidated by any add or remove of that kind of object
+	[[nodiscard]] std::span<Output * const> outputs() const;
+	[[nodiscard]] Output * output_at(Geo x, Geo y) const;
+	[[nodiscard]] std::span<Input * const> inputs() const;
+	[[nodiscard]] std::span<Workspace * const> workspaces() const;
+	[[nodiscard]] std::span<Window * const> windows() const;
 	[[nodiscard]] WindowsHistory * windows_history() const;
+	[[nodiscard]] LoopMonitor * loop_monitor() const;
 
 	[[nodiscard]] struct ::wlr_xdg_shell * xdg_shell() const;
+	[[nodiscard]] struct ::wlr_tearing_control_manager_v1 * tearing_control_manager() const;
+	[[nodiscard]] struct ::wlr_presentation * presentation() const;
+	[[nodiscard]] struct ::wlr_linux_drm_syncobj_manager_v1 * drm_syncobj_manager() const;
 
 	Server & set_data(void * data);
 	// TODO setters
 
-	Server & on_destroy(const Handler & handler);
-	Server & on_start(const Handler & handler);
-	Server & on_stop(const Handler & handler);
-	Server & on_output_layout_change(const OutputLayoutChangeHandler & handler);
-	Server & on_new_output(const NewOutputHandler & handler);
-	Server & on_new_input(const NewInputHandler & handler);
-	Server & on_new_xdg_shell_toplevel(const NewSurfaceHandler & handler);
-	Server & on_new_xdg_shell_popup(const NewSurfaceHandler & handler);
+	Server & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_start(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_stop(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_output_layout_change(const OutputLayoutChangeHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_new_output(const NewOutputHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_new_input(const NewInputHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_new_xdg_shell_toplevel(const NewSurfaceHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Server & on_new_xdg_shell_popup(const NewSurfaceHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
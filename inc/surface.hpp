@@ -5,6 +5,7 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
 
 namespace wlkit {
 
@@ -23,13 +24,13 @@ public:
 protected:
 	struct ::wlr_surface * _surface;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	std::list<Handler> _on_client_commit;
-	std::list<Handler> _on_commit;
-	std::list<Handler> _on_map;
-	std::list<Handler> _on_unmap;
-	std::list<NewSubsurfaceHandler> _on_new_subsurface;
+	HandlerList<Handler> _on_create{"Surface::on_create"};
+	HandlerList<Handler> _on_destroy{"Surface::on_destroy"};
+	HandlerList<Handler> _on_client_commit{"Surface::on_client_commit"};
+	HandlerList<Handler> _on_commit{"Surface::on_commit"};
+	HandlerList<Handler> _on_map{"Surface::on_map"};
+	HandlerList<Handler> _on_unmap{"Surface::on_unmap"};
+	HandlerList<NewSubsurfaceHandler> _on_new_subsurface{"Surface::on_new_subsurface"};
 
 	struct ::wl_listener _destroy_listener;
 	struct ::wl_listener _client_commit_listener;
@@ -86,12 +87,12 @@ public:
 
 	[[nodiscard]] struct ::wlr_surface * wlr_surface() const;
 
-	Surface & on_destroy(const Handler & handler);
-	Surface & on_client_commit(const Handler & handler);
-	Surface & on_commit(const Handler & handler);
-	Surface & on_map(const Handler & handler);
-	Surface & on_unmap(const Handler & handler);
-	Surface & on_new_subsurface(const NewSubsurfaceHandler & handler);
+	Surface & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Surface & on_client_commit(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Surface & on_commit(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Surface & on_map(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Surface & on_unmap(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Surface & on_new_subsurface(const NewSubsurfaceHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 protected:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
@@ -2,7 +2,10 @@
 
 extern "C" {
 #include <wlr/types/wlr_subcompositor.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/types/wlr_buffer.h>
 #include <wlr/types/wlr_foreign_toplevel_management_v1.h>
+#include <wlr/util/box.h>
 // #pragma push_macro("class")
 // #undef class
 // #define class class_field
@@ -12,6 +15,8 @@ extern "C" {
 }
 
 #include "common.hpp"
+#include "handler_list.hpp"
+#include "history.hpp"
 
 namespace wlkit {
 
@@ -21,10 +26,17 @@ public:
 	using NewSubsurfaceHandler = std::function<
 		void(Window * window, struct ::wlr_subsurface * subsurface)>;
 
+	enum class TearingPolicy {
+		CLIENT,
+		ALLOW,
+		DENY,
+	};
+
 private:
 	Server * _server;
 	Workspace * _workspace;
 	Surface * _surface;
+	struct ::wlr_scene_tree * _scene_tree;
 	char * _title;
 	char * _app_id;
 
@@ -33,23 +45,25 @@ private:
 	Geo _x, _y, _width, _height;
 	bool _mapped, _minimized, _maximized, _fullscreened;
 	bool _ready, _dirty, _resizing, _closed;
+	TearingPolicy _tearing_policy;
+	Thumbnail * _thumbnail;
 	WorkspacesHistory * _workspaces_history;
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	std::list<Handler> _on_close;
-	std::list<Handler> _on_set_title;
-	std::list<Handler> _on_set_app_id;
-	std::list<Handler> _on_move;
-	std::list<Handler> _on_resize;
-	std::list<Handler> _on_map;
-	std::list<Handler> _on_unmap;
-	std::list<Handler> _on_configure;
-	std::list<Handler> _on_ack_configure;
-	std::list<Handler> _on_commit;
-	std::list<Handler> _on_ping_timeout;
-	std::list<NewSubsurfaceHandler> _on_new_subsurface;
+	HandlerList<Handler> _on_create{"Window::on_create"};
+	HandlerList<Handler> _on_destroy{"Window::on_destroy"};
+	HandlerList<Handler> _on_close{"Window::on_close"};
+	HandlerList<Handler> _on_set_title{"Window::on_set_title"};
+	HandlerList<Handler> _on_set_app_id{"Window::on_set_app_id"};
+	HandlerList<Handler> _on_move{"Window::on_move"};
+	HandlerList<Handler> _on_resize{"Window::on_resize"};
+	HandlerList<Handler> _on_map{"Window::on_map"};
+	HandlerList<Handler> _on_unmap{"Window::on_unmap"};
+	HandlerList<Handler> _on_configure{"Window::on_configure"};
+	HandlerList<Handler> _on_ack_configure{"Window::on_ack_configure"};
+	HandlerList<Handler> _on_commit{"Window::on_commit"};
+	HandlerList<Handler> _on_ping_timeout{"Window::on_ping_timeout"};
+	HandlerList<NewSubsurfaceHandler> _on_new_subsurface{"Window::on_new_subsurface"};
 
 	struct ::wl_listener _destroy_listener;
 	struct ::wl_listener _set_title_listener;
@@ -61,6 +75,16 @@ private:
 	struct ::wl_listener _commit_listener;
 	struct ::wl_listener _ping_timeout_listener;
 	struct ::wl_listener _new_subsurface_listener;
+	struct ::wl_listener _new_popup_listener;
+
+	typedef struct {
+		Window * window;
+		struct ::wl_listener commit_listener;
+		struct ::wl_listener destroy_listener;
+		struct ::wl_listener new_popup_listener;
+	} Popup;
+
+	std::list<Popup> _popups;
 
 public:
 	Window(
@@ -83,20 +107,31 @@ public:
 	Window & unminimize();
 	Window & fullscreen();
 	Window & unfullscreen();
+	Window & damage();
+	Window & send_frame_done(const struct timespec * when);
+	Window & sample(Output * output, bool scanned_out = false);
 
 	[[nodiscard]] Server * server() const;
 	[[nodiscard]] Workspace * workspace() const;
+	[[nodiscard]] Output * output() const;
 	[[nodiscard]] Surface * surface() const;
+	[[nodiscard]] struct ::wlr_scene_tree * scene_tree() const;
+	[[nodiscard]] struct ::wlr_buffer * scanout_buffer() const;
 	[[nodiscard]] const char * title() const;
 	[[nodiscard]] const char * app_id() const;
 	[[nodiscard]] Geo x() const;
 	[[nodiscard]] Geo y() const;
 	[[nodiscard]] Geo width() const;
 	[[nodiscard]] Geo height() const;
+	[[nodiscard]] struct ::wlr_box bounds() const;
+	[[nodiscard]] struct ::wlr_surface * surface_at(Geo x, Geo y, Geo * sx, Geo * sy) const;
 	[[nodiscard]] bool mapped() const;
 	[[nodiscard]] bool minimized() const;
 	[[nodiscard]] bool maximized() const;
 	[[nodiscard]] bool fullscreened() const;
+	[[nodiscard]] TearingPolicy tearing_policy() const;
+	[[nodiscard]] bool allows_tearing() const;
+	[[nodiscard]] Thumbnail * thumbnail() const;
 	[[nodiscard]] bool ready() const;
 	[[nodiscard]] bool dirty() const;
 	[[nodiscard]] WorkspacesHistory * workspaces_history() const;
@@ -108,24 +143,30 @@ public:
 	Window & set_title(const char * title);
 	Window & set_app_id(const char * app_id);
 	Window & set_data(void * data);
-
-	Window & on_destroy(const Handler & handler);
-	Window & on_close(const Handler & handler);
-	Window & on_set_title(const Handler & handler);
-	Window & on_set_app_id(const Handler & handler);
-	Window & on_move(const Handler & handler);
-	Window & on_resize(const Handler & handler);
-	Window & on_map(const Handler & handler);
-	Window & on_unmap(const Handler & handler);
-	Window & on_configure(const Handler & handler);
-	Window & on_ack_configure(const Handler & handler);
-	Window & on_commit(const Handler & handler);
-	Window & on_ping_timeout(const Handler & handler);
-	Window & on_new_subsurface(const NewSubsurfaceHandler & handler);
+	Window & set_tearing_policy(TearingPolicy policy);
+	Window & enable_thumbnail(Geo max_width, Geo max_height);
+	Window & disable_thumbnail();
+
+	Window & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_close(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_set_title(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_set_app_id(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_move(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_resize(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_map(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_unmap(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_configure(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_ack_configure(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_commit(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_ping_timeout(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
+	Window & on_new_subsurface(const NewSubsurfaceHandler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	void _setup_xdg_toplevel();
 	void _configure_xdg_toplevel();
+	void _update_grid();
+	void _track_popup(struct ::wlr_xdg_popup * popup);
+	void _untrack_popup(Popup * popup);
 
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 	static void _handle_set_title(struct ::wl_listener * listener, void * data);
@@ -137,35 +178,43 @@ private:
 	static void _handle_commit(struct ::wl_listener * listener, void * data);
 	static void _handle_ping_timeout(struct ::wl_listener * listener, void * data);
 	static void _handle_new_subsurface(struct ::wl_listener * listener, void * data);
+	static void _handle_new_popup(struct ::wl_listener * listener, void * data);
+	static void _handle_popup_commit(struct ::wl_listener * listener, void * data);
+	static void _handle_popup_destroy(struct ::wl_listener * listener, void * data);
+	static void _handle_popup_new_popup(struct ::wl_listener * listener, void * data);
 };
 
-class WindowsHistory {
-public:
-	using Iterator = std::list<Window*>::iterator;
-	using ConstIterator = std::list<Window*>::const_iterator;
-
+class Thumbnail {
 private:
-	std::list<Window*> _order;
-	std::unordered_map<Window*, std::list<Window*>::iterator> _pos;
+	Window * _window;
+	Output * _output;
+	struct ::wlr_buffer * _buffer;
+	struct ::wlr_texture * _texture;
+	Geo _max_width, _max_height;
+	int _width, _height;
+	struct ::wlr_box _box;
+	bool _dirty;
 
 public:
-	WindowsHistory();
-	~WindowsHistory();
-
-	const std::list<Window*> & history() const;
-
-	WindowsHistory & shift(Window * workspace);
-	WindowsHistory & remove(Window * workspace);
-
-	Window * top() const;
-	Window * previous() const;
+	Thumbnail(Window * window, Geo max_width, Geo max_height);
+	~Thumbnail();
+
+	Thumbnail & mark_dirty();
+	Thumbnail & set_max_size(Geo max_width, Geo max_height);
+	Thumbnail & show_on(Output * output, const struct ::wlr_box * box = nullptr);
+	bool update();
+
+	[[nodiscard]] Window * window() const;
+	[[nodiscard]] Output * output() const;
+	[[nodiscard]] const struct ::wlr_box * box() const;
+	[[nodiscard]] struct ::wlr_texture * texture() const;
+	[[nodiscard]] int width() const;
+	[[nodiscard]] int height() const;
+	[[nodiscard]] bool dirty() const;
 
-	Iterator begin();
-	Iterator end();
-	ConstIterator begin() const;
-	ConstIterator end() const;
-	ConstIterator cbegin() const;
-	ConstIterator cend() const;
+private:
+	bool _allocate(int width, int height);
+	void _release();
 };
 
 }
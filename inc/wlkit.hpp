@@ -2,6 +2,7 @@
 
 #include "seat.hpp"
 #include "server.hpp"
+#include "loop_monitor.hpp"
 #include "root.hpp"
 #include "node.hpp"
 #include "cursor.hpp"
@@ -10,6 +11,7 @@
 #include "workspace.hpp"
 #include "layout.hpp"
 #include "window.hpp"
+#include "overview.hpp"
 
 #include "device/keyboard.hpp"
 #include "device/pointer.hpp"
@@ -1,6 +1,16 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <wlr/util/box.h>
+}
+
 #include "common.hpp"
+#include "dense_set.hpp"
+#include "handler_list.hpp"
+#include "history.hpp"
 
 namespace wlkit {
 
@@ -15,19 +25,21 @@ private:
 
 	ID _id;
 	char * _name;
-	std::list<Window*> _windows;
+	DenseSet<Window*> _windows;
 	WindowsHistory * _windows_history;
+	WindowGrid * _grid;
 	Window * _focused_window;
 	Output * _output;
+	struct ::wlr_scene_tree * _scene_tree;
 	void * _data;
 
-	std::list<Handler> _on_create;
-	std::list<Handler> _on_destroy;
-	// std::list<Handler> _on_activate;
-	// std::list<Handler> _on_deactivate;
-	// std::list<Handler> _on_window_added;
-	// std::list<Handler> _on_window_removed;
-	// std::list<Handler> _on_layout_change;
+	HandlerList<Handler> _on_create{"Workspace::on_create"};
+	HandlerList<Handler> _on_destroy{"Workspace::on_destroy"};
+	// HandlerList<Handler> _on_activate{"Workspace::on_activate"};
+	// HandlerList<Handler> _on_deactivate{"Workspace::on_deactivate"};
+	// HandlerList<Handler> _on_window_added{"Workspace::on_window_added"};
+	// HandlerList<Handler> _on_window_removed{"Workspace::on_window_removed"};
+	// HandlerList<Handler> _on_layout_change{"Workspace::on_layout_change"};
 
 	struct ::wl_listener _destroy_listener;
 
@@ -48,48 +60,65 @@ public:
 	[[nodiscard]] Layout * layout() const;
 	[[nodiscard]] ID id() const;
 	[[nodiscard]] const char * name() const;
-	[[nodiscard]] std::list<Window*> windows() const;
+	[[nodiscard]] std::span<Window * const> windows() const;
 	[[nodiscard]] WindowsHistory * windows_history() const;
+	[[nodiscard]] WindowGrid * grid() const;
 	[[nodiscard]] Window * focused_window() const;
 	[[nodiscard]] Output * output() const;
+	[[nodiscard]] struct ::wlr_scene_tree * scene_tree() const;
 	[[nodiscard]] void * data() const;
 
 	Workspace & set_output(Output * output);
 	// TODO setters
 
-	Workspace & on_destroy(const Handler & handler);
+	Workspace & on_destroy(const Handler & handler, const char * name = nullptr, Subscription * subscription = nullptr);
 
 private:
 	static void _handle_destroy(struct ::wl_listener * listener, void * data);
 };
 
-class WorkspacesHistory {
+class WindowGrid {
 public:
-	using Iterator = std::list<Workspace*>::iterator;
-	using ConstIterator = std::list<Workspace*>::const_iterator;
+	static constexpr int CELL_SIZE = 256;
+
+	typedef struct {
+		Window * window;
+		struct ::wlr_surface * surface;
+		Geo sx;
+		Geo sy;
+	} Hit;
 
 private:
-	std::list<Workspace*> _order;
-	std::unordered_map<Workspace*, std::list<Workspace*>::iterator> _pos;
+	typedef struct {
+		struct ::wlr_box box;
+		uint64_t z;
+	} Entry;
+
+	std::unordered_map<Window*, Entry> _entries;
+	std::unordered_map<uint64_t, std::vector<Window*>> _cells;
+	uint64_t _next_z;
 
 public:
-	WorkspacesHistory();
-	~WorkspacesHistory();
+	WindowGrid();
+	~WindowGrid();
 
-	const std::list<Workspace*> & history() const;
+	WindowGrid & update(Window * window);
+	WindowGrid & raise(Window * window);
+	WindowGrid & remove(Window * window);
+	WindowGrid & clear();
 
-	WorkspacesHistory & shift(Workspace * workspace);
-	WorkspacesHistory & remove(Workspace * workspace);
+	[[nodiscard]] bool hit_test(Geo x, Geo y, Hit * hit) const;
+	[[nodiscard]] Window * window_at(Geo x, Geo y) const;
+	[[nodiscard]] size_t size() const;
 
-	Workspace * top() const;
-	Workspace * previous() const;
+private:
+	void _insert(Window * window, const struct ::wlr_box & box);
+	void _erase(Window * window, const struct ::wlr_box & box);
 
-	Iterator begin();
-	Iterator end();
-	ConstIterator begin() const;
-	ConstIterator end() const;
-	ConstIterator cbegin() const;
-	ConstIterator cend() const;
+	template <typename F>
+	static void _for_each_cell(const struct ::wlr_box & box, F && f);
+	static uint64_t _key(int cx, int cy);
+	static int _cell(int coord);
 };
 
 }
@@ -15,6 +15,9 @@ _root(root), _data(nullptr) {
 	_xcursor_manager = wlr_xcursor_manager_create(name, size);
 	wlr_xcursor_manager_load(_xcursor_manager, 1);
 
+	// wlr_cursor puts the image on a hardware plane of every output that has one
+	wlr_cursor_set_xcursor(_wlr_cursor, _xcursor_manager, "default");
+
 	_destroy_listener.notify = _handle_destroy;
 
 	if (callback) {
@@ -24,9 +27,7 @@ _root(root), _data(nullptr) {
 }
 
 Cursor::~Cursor() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
 	wlr_cursor_destroy(_wlr_cursor);
 	wlr_xcursor_manager_destroy(_xcursor_manager);
@@ -44,18 +45,41 @@ struct wlr_xcursor_manager * Cursor::wlr_xcursor_manager() const {
 	return _xcursor_manager;
 }
 
+Geo Cursor::x() const {
+	return _wlr_cursor->x;
+}
+
+Geo Cursor::y() const {
+	return _wlr_cursor->y;
+}
+
 void * Cursor::data() const {
 	return _data;
 }
 
+Cursor & Cursor::attach(struct wlr_input_device * device) {
+	wlr_cursor_attach_input_device(_wlr_cursor, device);
+	return *this;
+}
+
+Cursor & Cursor::detach(struct wlr_input_device * device) {
+	wlr_cursor_detach_input_device(_wlr_cursor, device);
+	return *this;
+}
+
+Cursor & Cursor::set_image(const char * name) {
+	wlr_cursor_set_xcursor(_wlr_cursor, _xcursor_manager, name);
+	return *this;
+}
+
 Cursor & Cursor::set_data(void * data) {
 	_data = data;
 	return *this;
 }
 
-Cursor & Cursor::on_destroy(const Handler & handler) {
+Cursor & Cursor::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -0,0 +1,154 @@
+#include <algorithm>
+
+#include "render.hpp"
+
+using namespace wlkit;
+
+DisplayList::DisplayList():
+_compiled_width(0), _compiled_height(0), _dirty(true) {}
+
+DisplayList::~DisplayList() {}
+
+DisplayList & DisplayList::clear() {
+	_rects.clear();
+	_textures.clear();
+	_items.clear();
+	_dirty = true;
+	return *this;
+}
+
+DisplayList & DisplayList::add_rect(const struct wlr_box & box, const struct wlr_render_color & color) {
+	_items.push_back({ Kind::RECT, _rects.size() });
+	_rects.push_back({ box, color });
+	_dirty = true;
+	return *this;
+}
+
+DisplayList & DisplayList::add_rects(std::span<const Rect> rects) {
+	_items.reserve(_items.size() + rects.size());
+	for (size_t i = 0; i < rects.size(); ++i) {
+		_items.push_back({ Kind::RECT, _rects.size() + i });
+	}
+	_rects.insert(_rects.end(), rects.begin(), rects.end());
+	_dirty = true;
+	return *this;
+}
+
+DisplayList & DisplayList::add_texture(const Texture & texture) {
+	_items.push_back({ Kind::TEXTURE, _textures.size() });
+	_textures.push_back(texture);
+	_dirty = true;
+	return *this;
+}
+
+DisplayList & DisplayList::add_textures(std::span<const Texture> textures) {
+	_items.reserve(_items.size() + textures.size());
+	for (size_t i = 0; i < textures.size(); ++i) {
+		_items.push_back({ Kind::TEXTURE, _textures.size() + i });
+	}
+	_textures.insert(_textures.end(), textures.begin(), textures.end());
+	_dirty = true;
+	return *this;
+}
+
+DisplayList & DisplayList::submit(struct wlr_render_pass * pass, int width, int height, const pixman_region32_t * clip) {
+	if (!pass) {
+		return *this;
+	}
+
+	if (_dirty || width != _compiled_width || height != _compiled_height) {
+		_compile(width, height);
+	}
+
+	for (auto & item : _compiled) {
+		if (item.kind == Kind::RECT) {
+			auto opts = _compiled_rects[item.index];
+			opts.clip = clip;
+			wlr_render_pass_add_rect(pass, &opts);
+		} else {
+			auto opts = _compiled_textures[item.index];
+			opts.clip = clip;
+			wlr_render_pass_add_texture(pass, &opts);
+		}
+	}
+
+	return *this;
+}
+
+size_t DisplayList::size() const {
+	return _items.size();
+}
+
+size_t DisplayList::compiled_size() const {
+	return _compiled.size();
+}
+
+bool DisplayList::dirty() const {
+	return _dirty;
+}
+
+void DisplayList::_compile(int width, int height) {
+	_compiled_rects.clear();
+	_compiled_textures.clear();
+	_compiled.clear();
+
+	struct wlr_box bounds = { 0, 0, width, height };
+
+	for (auto & item : _items) {
+		if (item.kind == Kind::TEXTURE) {
+			auto & texture = _textures[item.index];
+			struct wlr_box visible;
+			if (!texture.texture || !wlr_box_intersection(&visible, &texture.dst_box, &bounds)) {
+				continue;
+			}
+
+			struct wlr_render_texture_options opts{};
+			opts.texture = texture.texture;
+			opts.src_box = texture.src_box;
+			opts.dst_box = texture.dst_box;
+			opts.alpha = texture.alpha < 1.0f ? &texture.alpha : nullptr;
+			opts.transform = texture.transform;
+
+			_compiled.push_back({ Kind::TEXTURE, _compiled_textures.size() });
+			_compiled_textures.push_back(opts);
+			continue;
+		}
+
+		auto & rect = _rects[item.index];
+		struct wlr_box box;
+		if (rect.color.a <= 0.0f || !wlr_box_intersection(&box, &rect.box, &bounds)) {
+			continue;
+		}
+
+		// adjacent rects of one colour never overlap, so merging keeps blending exact
+		if (!_compiled.empty() && _compiled.back().kind == Kind::RECT) {
+			auto & last = _compiled_rects.back();
+			bool same_color = last.color.r == rect.color.r && last.color.g == rect.color.g &&
+				last.color.b == rect.color.b && last.color.a == rect.color.a;
+			bool row = last.box.y == box.y && last.box.height == box.height &&
+				last.box.x + last.box.width == box.x;
+			bool column = last.box.x == box.x && last.box.width == box.width &&
+				last.box.y + last.box.height == box.y;
+
+			if (same_color && row) {
+				last.box.width += box.width;
+				continue;
+			}
+			if (same_color && column) {
+				last.box.height += box.height;
+				continue;
+			}
+		}
+
+		struct wlr_render_rect_options opts{};
+		opts.box = box;
+		opts.color = rect.color;
+
+		_compiled.push_back({ Kind::RECT, _compiled_rects.size() });
+		_compiled_rects.push_back(opts);
+	}
+
+	_compiled_width = width;
+	_compiled_height = height;
+	_dirty = false;
+}
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+
+#include "output.hpp"
+
+using namespace wlkit;
+
+FrameStats::FrameStats():
+_frames{}, _head(0), _size(0), _refresh(0), _measured_refresh(0), _last_present(0),
+_n_frames(0), _n_presented(0), _missed_vblanks(0) {}
+
+FrameStats::~FrameStats() {}
+
+FrameStats & FrameStats::record(const Frame & frame) {
+	_frames[_head] = frame;
+	_frames[_head].present = 0;
+	_frames[_head].presented = false;
+	_frames[_head].discarded = false;
+	_head = (_head + 1) % CAPACITY;
+	if (_size < CAPACITY) {
+		++_size;
+	}
+	++_n_frames;
+	return *this;
+}
+
+FrameStats & FrameStats::record_present(Output::CommitSeq commit_seq, Nsec when, Nsec refresh, bool presented) {
+	if (refresh > 0) {
+		_refresh = refresh;
+	}
+
+	Frame * frame = _find(commit_seq);
+	if (!frame) {
+		return *this;
+	}
+	if (!presented) {
+		frame->discarded = true;
+		return *this;
+	}
+
+	frame->present = when;
+	frame->presented = true;
+	++_n_presented;
+
+	// a frame started at a vblank is on time when it shows at the next one
+	if (_refresh > 0 && frame->vblank > 0 && when > frame->vblank) {
+		Nsec vblanks = std::llround(static_cast<double>(when - frame->vblank) / _refresh);
+		if (vblanks > 1) {
+			_missed_vblanks += vblanks - 1;
+		}
+	}
+
+	if (_refresh > 0 && _last_present > 0 && when > _last_present) {
+		Nsec delta = when - _last_present;
+		Nsec vblanks = std::max<Nsec>(1, std::llround(static_cast<double>(delta) / _refresh));
+		Nsec sample = delta / vblanks;
+		_measured_refresh = _measured_refresh > 0
+			? _measured_refresh + (sample - _measured_refresh) / 16
+			: sample;
+	}
+	_last_present = when;
+
+	return *this;
+}
+
+FrameStats & FrameStats::reset() {
+	_head = 0;
+	_size = 0;
+	_measured_refresh = 0;
+	_last_present = 0;
+	_n_frames = 0;
+	_n_presented = 0;
+	_missed_vblanks = 0;
+	return *this;
+}
+
+size_t FrameStats::size() const {
+	return _size;
+}
+
+const FrameStats::Frame & FrameStats::frame(size_t age) const {
+	return _frames[(_head + CAPACITY - 1 - age % CAPACITY) % CAPACITY];
+}
+
+Nsec FrameStats::percentile(Metric metric, double p) const {
+	// at most one value per recorded frame, no allocation per query
+	std::array<Nsec, CAPACITY> values;
+	size_t n = 0;
+
+	for (size_t age = 0; age < _size; ++age) {
+		const Frame & f = frame(age);
+		switch (metric) {
+		case Metric::HANDLER:
+			values[n++] = f.handler;
+			break;
+		case Metric::SUBMIT:
+			values[n++] = f.submit;
+			break;
+		case Metric::COMMIT:
+			values[n++] = f.commit;
+			break;
+		case Metric::LATENCY:
+			if (f.presented) {
+				values[n++] = f.present - f.vblank;
+			}
+			break;
+		case Metric::INTERVAL:
+			// only back-to-back frames, idle gaps are not intervals
+			if (f.presented && age + 1 < _size) {
+				const Frame & prev = frame(age + 1);
+				if (prev.presented && f.vblank <= prev.present + _refresh / 2) {
+					values[n++] = f.present - prev.present;
+				}
+			}
+			break;
+		}
+	}
+
+	if (n == 0) {
+		return 0;
+	}
+
+	p = std::clamp(p, 0.0, 1.0);
+	auto end = values.begin() + static_cast<std::ptrdiff_t>(n);
+	auto nth = values.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(n - 1) + 0.5);
+	std::nth_element(values.begin(), nth, end);
+	return *nth;
+}
+
+Nsec FrameStats::p50(Metric metric) const {
+	return percentile(metric, 0.5);
+}
+
+Nsec FrameStats::p99(Metric metric) const {
+	return percentile(metric, 0.99);
+}
+
+Nsec FrameStats::refresh_interval() const {
+	if (_measured_refresh > 0) {
+		return _measured_refresh;
+	}
+	if (_refresh > 0) {
+		return _refresh;
+	}
+	return p50(Metric::INTERVAL);
+}
+
+uint64_t FrameStats::frames() const {
+	return _n_frames;
+}
+
+uint64_t FrameStats::presented() const {
+	return _n_presented;
+}
+
+uint64_t FrameStats::missed_vblanks() const {
+	return _missed_vblanks;
+}
+
+FrameStats::Frame * FrameStats::_find(Output::CommitSeq commit_seq) {
+	for (size_t age = 0; age < _size; ++age) {
+		auto & f = _frames[(_head + CAPACITY - 1 - age) % CAPACITY];
+		if (f.commit_seq == commit_seq) {
+			return f.presented || f.discarded ? nullptr : &f;
+		}
+	}
+
+	// commits that are not frames, e.g. a cursor move or planes alone, are not tracked
+	return nullptr;
+}
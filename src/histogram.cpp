@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <bit>
+
+#include "histogram.hpp"
+
+using namespace wlkit;
+
+static constexpr Nsec BASE = 1000;
+static constexpr Nsec SUB = static_cast<Nsec>(LatencyHistogram::SUB_BUCKETS);
+
+LatencyHistogram::LatencyHistogram():
+_buckets{}, _count(0), _sum(0), _min(0), _max(0) {}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+LatencyHistogram & LatencyHistogram::add(Nsec latency) {
+	latency = std::max<Nsec>(latency, 0);
+	++_buckets[_bucket(latency)];
+	_min = _count ? std::min(_min, latency) : latency;
+	_max = std::max(_max, latency);
+	_sum += latency;
+	++_count;
+	return *this;
+}
+
+LatencyHistogram & LatencyHistogram::reset() {
+	_buckets.fill(0);
+	_count = 0;
+	_sum = 0;
+	_min = 0;
+	_max = 0;
+	return *this;
+}
+
+uint64_t LatencyHistogram::count() const {
+	return _count;
+}
+
+Nsec LatencyHistogram::min() const {
+	return _min;
+}
+
+Nsec LatencyHistogram::max() const {
+	return _max;
+}
+
+Nsec LatencyHistogram::mean() const {
+	return _count ? _sum / static_cast<Nsec>(_count) : 0;
+}
+
+Nsec LatencyHistogram::percentile(double p) const {
+	if (!_count) {
+		return 0;
+	}
+
+	p = std::clamp(p, 0.0, 1.0);
+	auto rank = static_cast<uint64_t>(p * static_cast<double>(_count - 1)) + 1;
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKETS; ++i) {
+		seen += _buckets[i];
+		if (seen >= rank) {
+			// the bucket bound overestimates, the extremes are known exactly
+			return std::clamp(bucket_upper(i), _min, _max);
+		}
+	}
+	return _max;
+}
+
+Nsec LatencyHistogram::p50() const {
+	return percentile(0.5);
+}
+
+Nsec LatencyHistogram::p99() const {
+	return percentile(0.99);
+}
+
+const std::array<uint64_t, LatencyHistogram::BUCKETS> & LatencyHistogram::buckets() const {
+	return _buckets;
+}
+
+Nsec LatencyHistogram::bucket_lower(size_t bucket) {
+	if (bucket == 0) {
+		return 0;
+	}
+	size_t octave = bucket / SUB_BUCKETS;
+	size_t sub = bucket % SUB_BUCKETS;
+	Nsec low = BASE << octave;
+	return low + static_cast<Nsec>(sub) * (low / SUB);
+}
+
+Nsec LatencyHistogram::bucket_upper(size_t bucket) {
+	return bucket + 1 < BUCKETS ? bucket_lower(bucket + 1) : INT64_MAX;
+}
+
+size_t LatencyHistogram::_bucket(Nsec latency) {
+	if (latency < BASE + BASE / SUB) {
+		return 0;
+	}
+
+	auto units = static_cast<uint64_t>(latency / BASE);
+	size_t octave = static_cast<size_t>(std::bit_width(units)) - 1;
+	Nsec low = BASE << octave;
+	size_t sub = static_cast<size_t>((latency - low) / (low / SUB));
+	return std::min(octave * SUB_BUCKETS + sub, BUCKETS - 1);
+}
@@ -1,9 +1,14 @@
 #include "input.hpp"
+#include "server.hpp"
+#include "root.hpp"
+#include "cursor.hpp"
+#include "output.hpp"
 
 using namespace wlkit;
 
 Input::Input(Server * server, const Type & type, struct wlr_input_device * device, const Handler & callback):
-_server(server), _type(type), _device(device), _data(nullptr) {
+_server(server), _type(type), _device(device), _last_event(0), _data(nullptr) {
+	_latency = new LatencyHistogram();
 	_destroy_listener.notify = _handle_destroy;
 
 	if (callback) {
@@ -13,9 +18,13 @@ _server(server), _type(type), _device(device), _data(nullptr) {
 }
 
 Input::~Input() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
+	_on_destroy.emit(this);
+
+	_server->remove_input(this);
+	for (auto output : _server->outputs()) {
+		output->forget_input(this);
 	}
+	delete _latency;
 }
 
 bool Input::is_keyboard() const {
@@ -54,6 +63,14 @@ struct wlr_input_device * Input::device() const {
 	return _device;
 }
 
+Nsec Input::last_event() const {
+	return _last_event;
+}
+
+LatencyHistogram * Input::latency() const {
+	return _latency;
+}
+
 void * Input::data() const {
 	return _data;
 }
@@ -63,11 +80,21 @@ Input & Input::set_data(void *data) {
 	return *this;
 }
 
-Input & Input::on_destroy(const Handler &handler) {
-	_on_destroy.push_back(handler);
+Input & Input::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
+	_on_destroy.push_back(handler, name, subscription);
 	return *this;
 }
 
+void Input::_stamp() {
+	_last_event = monotonic_nsec();
+
+	// the effect shows on the output under the cursor, that is where the seat works
+	auto cursor = _server->root()->cursor();
+	if (auto output = _server->output_at(cursor->x(), cursor->y())) {
+		output->add_input(this, _last_event);
+	}
+}
+
 void Input::_handle_destroy(struct wl_listener * listener, void * data) {
 	Input * input = wl_container_of(listener, input, _destroy_listener);
 	delete input;
@@ -146,57 +146,54 @@ Keyboard & Keyboard::set_options(const char * options) {
 	return *this;
 }
 
-Keyboard & Keyboard::on_key(const KeyHandler & handler) {
+Keyboard & Keyboard::on_key(const KeyHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_key.push_back(std::move(handler));
+		_on_key.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Keyboard & Keyboard::on_key_pressed(const KeyStateHandler & handler) {
+Keyboard & Keyboard::on_key_pressed(const KeyStateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_key_pressed.push_back(std::move(handler));
+		_on_key_pressed.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Keyboard & Keyboard::on_key_released(const KeyStateHandler & handler) {
+Keyboard & Keyboard::on_key_released(const KeyStateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_key_released.push_back(std::move(handler));
+		_on_key_released.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Keyboard & Keyboard::on_mod(const ModHandler & handler) {
+Keyboard & Keyboard::on_mod(const ModHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_mod.push_back(std::move(handler));
+		_on_mod.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Keyboard & Keyboard::on_repeat(const RepeatHandler & handler) {
+Keyboard & Keyboard::on_repeat(const RepeatHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_repeat.push_back(std::move(handler));
+		_on_repeat.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
 void Keyboard::_handle_key(struct wl_listener * listener, void * data) {
 	Keyboard * keyboard = wl_container_of(listener, keyboard, _key_listener);
+	keyboard->_stamp();
 	auto event = static_cast<struct wlr_keyboard_key_event*>(data);
 	if (!keyboard->_kbd->xkb_state) {
 		return;
 	}
 
- 	for (auto & cb : keyboard->_on_key) {
-		cb(keyboard, event->keycode, event->state);
-	}
+	keyboard->_on_key.emit(keyboard, event->keycode, event->state);
 
-	auto handlers = event->state == WL_KEYBOARD_KEY_STATE_PRESSED
+	auto & handlers = event->state == WL_KEYBOARD_KEY_STATE_PRESSED
 		? keyboard->_on_key_pressed : keyboard->_on_key_released;
-	for (auto & cb : handlers) {
-		cb(keyboard, event->keycode);
-	}
+	handlers.emit(keyboard, event->keycode);
 }
 
 void Keyboard::_handle_mod(struct wl_listener * listener, void * data) {
@@ -206,9 +203,7 @@ void Keyboard::_handle_mod(struct wl_listener * listener, void * data) {
 		return;
 	}
 
- 	for (auto & cb : keyboard->_on_mod) {
-		cb(keyboard, mods);
-	}
+	keyboard->_on_mod.emit(keyboard, mods);
 }
 
 void Keyboard::_handle_repeat(struct wl_listener * listener, void * data) {
@@ -218,7 +213,5 @@ void Keyboard::_handle_repeat(struct wl_listener * listener, void * data) {
 		return;
 	}
 
- 	for (auto & cb : keyboard->_on_repeat) {
-		cb(keyboard, info->rate, info->delay);
-	}
+	keyboard->_on_repeat.emit(keyboard, info->rate, info->delay);
 }
@@ -15,9 +15,7 @@ _data(nullptr) {
 };
 
 Layout::~Layout() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
 	free(_name);
 }
@@ -35,9 +33,9 @@ Layout & Layout::set_data(void * data) {
 	return *this;
 }
 
-Layout & Layout::on_destroy(const Handler & handler) {
+Layout & Layout::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cerrno>
+
+extern "C" {
+#include <sys/epoll.h>
+}
+
+#include "loop_monitor.hpp"
+#include "server.hpp"
+
+using namespace wlkit;
+
+LoopMonitor::LoopMonitor(Server * server):
+_server(server), _stall_threshold(DEFAULT_STALL_THRESHOLD),
+_wakeups(0), _events(0), _max_events(0), _stalls(0), _timers(0),
+_busy(0), _started(monotonic_nsec()) {
+	if (!_server) {
+		// TODO error
+	}
+}
+
+LoopMonitor::~LoopMonitor() {}
+
+bool LoopMonitor::run() {
+	auto display = _server->display();
+	auto event_loop = _server->event_loop();
+
+	wl_display_flush_clients(display);
+	wl_event_loop_dispatch_idle(event_loop);
+
+	// the loop's fd is a level-triggered epoll, peeking does not consume what it reports
+	struct epoll_event ready[32];
+	int n_ready = epoll_wait(wl_event_loop_get_fd(event_loop), ready, 32, -1);
+	if (n_ready < 0 && errno != EINTR) {
+		// TODO error
+		return false;
+	}
+
+	Nsec start = monotonic_nsec();
+	wl_event_loop_dispatch(event_loop, 0);
+	Nsec duration = monotonic_nsec() - start;
+
+	auto events = static_cast<uint64_t>(n_ready > 0 ? n_ready : 0);
+	++_wakeups;
+	_events += events;
+	_max_events = std::max(_max_events, events);
+	_busy += duration;
+	_dispatch.add(duration);
+
+	if (duration >= _stall_threshold) {
+		++_stalls;
+		_on_stall.emit(this, duration);
+	}
+
+	return true;
+}
+
+LoopMonitor & LoopMonitor::record_timer(Nsec deadline) {
+	if (deadline <= 0) {
+		return *this;
+	}
+
+	++_timers;
+	_timer_lag.add(monotonic_nsec() - deadline);
+	return *this;
+}
+
+LoopMonitor & LoopMonitor::reset() {
+	_wakeups = 0;
+	_events = 0;
+	_max_events = 0;
+	_stalls = 0;
+	_timers = 0;
+	_busy = 0;
+	_started = monotonic_nsec();
+	_dispatch.reset();
+	_timer_lag.reset();
+	return *this;
+}
+
+Server * LoopMonitor::server() const {
+	return _server;
+}
+
+Nsec LoopMonitor::stall_threshold() const {
+	return _stall_threshold;
+}
+
+uint64_t LoopMonitor::wakeups() const {
+	return _wakeups;
+}
+
+uint64_t LoopMonitor::events() const {
+	return _events;
+}
+
+uint64_t LoopMonitor::max_events() const {
+	return _max_events;
+}
+
+double LoopMonitor::events_per_wakeup() const {
+	return _wakeups ? static_cast<double>(_events) / static_cast<double>(_wakeups) : 0.0;
+}
+
+uint64_t LoopMonitor::stalls() const {
+	return _stalls;
+}
+
+uint64_t LoopMonitor::timers() const {
+	return _timers;
+}
+
+double LoopMonitor::load() const {
+	Nsec elapsed = monotonic_nsec() - _started;
+	return elapsed > 0 ? static_cast<double>(_busy) / static_cast<double>(elapsed) : 0.0;
+}
+
+const LatencyHistogram & LoopMonitor::dispatch() const {
+	return _dispatch;
+}
+
+const LatencyHistogram & LoopMonitor::timer_lag() const {
+	return _timer_lag;
+}
+
+LoopMonitor & LoopMonitor::set_stall_threshold(Nsec threshold) {
+	_stall_threshold = threshold > 0 ? threshold : DEFAULT_STALL_THRESHOLD;
+	return *this;
+}
+
+LoopMonitor & LoopMonitor::on_stall(const StallHandler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_stall.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
@@ -20,9 +20,7 @@ _type(type), _object(object), _data(nullptr) {
 }
 
 Node::~Node() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 }
 
 Node & Node::init() {
@@ -50,9 +48,9 @@ Node & Node::set_data(void * data) {
 	return *this;
 }
 
-Root & Node::on_destroy(const Handler & handler) {
+Root & Node::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 }
 
@@ -1,14 +1,23 @@
+#include <algorithm>
+#include <cmath>
+
 #include "output.hpp"
 #include "server.hpp"
 #include "root.hpp"
 #include "workspace.hpp"
 #include "render.hpp"
 #include "window.hpp"
+#include "input.hpp"
 
 using namespace wlkit;
 
 Output::Output(Server * server, struct wlr_output * wlr_output, const Handler & callback):
-_server(server), _wlr_output(wlr_output), _current_workspace(nullptr), _data(nullptr) {
+_server(server), _wlr_output(wlr_output), _x(0), _y(0), _render_mode(RenderMode::CUSTOM),
+_max_render_time(MAX_RENDER_TIME_OFF), _direct_scanout(false), _scanned_out(false), _frame_requested(false), _repaint_scheduled(false), _layer_offload(false), _layers(nullptr),
+_frame_pacing(FramePacing::FIXED), _vrr_min_refresh(48000), _vrr_max_refresh(0),
+_last_content_commit(0), _content_interval(0), _last_frame{}, _last_presentation{}, _refresh_nsec(0),
+_render_durations{}, _n_render_durations(0), _render_durations_head(0),
+_current_workspace(nullptr), _data(nullptr) {
 	if (!_server || !_wlr_output) {
 		// TODO error
 	}
@@ -27,6 +36,9 @@ _server(server), _wlr_output(wlr_output), _current_workspace(nullptr), _data(nul
 	}
 
 	_repaint_timer = wl_event_loop_add_timer(event_loop, _handle_repaint_timer, this);
+	_lfc_timer = wl_event_loop_add_timer(event_loop, _handle_lfc_timer, this);
+	_repaint_deadline = 0;
+	_lfc_deadline = 0;
 
 	if (!wlr_output_init_render(_wlr_output, allocator, renderer)) {
 		wlr_scene_output_destroy(_scene_output);
@@ -36,11 +48,23 @@ _server(server), _wlr_output(wlr_output), _current_workspace(nullptr), _data(nul
 	_state = new wlr_output_state{};
 	wlr_output_state_init(_state);
 
+	wlr_damage_ring_init(&_damage_ring);
+	_render = new Render(this, nullptr);
+
 	_destroy_listener.notify = _handle_destroy;
 	wl_signal_add(&_wlr_output->events.destroy, &_destroy_listener);
 	wl_signal_add(&_scene_output->events.destroy, &_destroy_listener);
 
 	_workspaces_history = new WorkspacesHistory();
+	_frame_stats = new FrameStats();
+	_input_latency = new LatencyHistogram();
+	_budget_share = 0.0;
+	_budget_frames = 3;
+	_over_budget = 0;
+	_within_budget = 0;
+	_auto_degrade = false;
+	_degraded = false;
+	_layers = new OutputLayers(this);
 
 	struct wlr_output_state state;
 	wlr_output_state_init(&state);
@@ -48,6 +72,16 @@ _server(server), _wlr_output(wlr_output), _current_workspace(nullptr), _data(nul
 	_frame_listener.notify = _handle_frame;
 	wl_signal_add(&_wlr_output->events.frame, &_frame_listener);
 
+	_present_listener.notify = _handle_present;
+	wl_signal_add(&_wlr_output->events.present, &_present_listener);
+	_needs_frame_listener.notify = _handle_needs_frame;
+	wl_signal_add(&_wlr_output->events.needs_frame, &_needs_frame_listener);
+	_damage_listener.notify = _handle_damage;
+	wl_signal_add(&_wlr_output->events.damage, &_damage_listener);
+
+	// the cursor follows the layout, hardware cursor planes come with it
+	wlr_output_layout_add(root->output_layout(), _wlr_output, static_cast<int>(_x), static_cast<int>(_y));
+
 	if (callback) {
 		_on_create.push_back(std::move(callback));
 		callback(this);
@@ -55,12 +89,26 @@ _server(server), _wlr_output(wlr_output), _current_workspace(nullptr), _data(nul
 }
 
 Output::~Output() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
+	_server->remove_output(this);
+	for (auto workspace : _workspaces) {
+		workspace->set_output(nullptr);
+	}
+	wl_list_remove(&_present_listener.link);
+	wl_list_remove(&_needs_frame_listener.link);
+	wl_list_remove(&_damage_listener.link);
+	wlr_output_layout_remove(_server->root()->output_layout(), _wlr_output);
+	wl_event_source_remove(_repaint_timer);
+	wl_event_source_remove(_lfc_timer);
+
+	delete _layers;
+	delete _render;
 	delete _workspaces_history;
+	delete _frame_stats;
+	delete _input_latency;
 	delete _state;
+	wlr_damage_ring_finish(&_damage_ring);
 	wlr_scene_output_destroy(_scene_output);
 }
 
@@ -111,20 +159,108 @@ Output & Output::setup_gamma_lut(const GammaLUT * gamma_lut) {
 Output & Output::commit_state() {
 	wlr_output_commit_state(_wlr_output, _state);
 	wlr_output_state_finish(_state);
+	damage_whole();
 	return *this;
 }
 
-Window * Output::window_at(Geo x, Geo y) {
-	for (Window * window : *_current_workspace->windows_history()) {
-		if (window->mapped() &&
-			x >= window->x() && x < window->x() + window->width() &&
-			y >= window->y() && y < window->y() + window->height()
-		) {
-			return window;
+// the box is output-local in logical coordinates, the damage ring wants buffer coordinates
+Output & Output::damage_box(const struct wlr_box * box) {
+	if (!box || wlr_box_empty(box)) {
+		return *this;
+	}
+
+	struct wlr_box buffer_box = this->buffer_box(box);
+	return damage_buffer_box(&buffer_box);
+}
+
+Output & Output::damage_buffer_box(const struct wlr_box * box) {
+	if (!box || wlr_box_empty(box)) {
+		return *this;
+	}
+
+	wlr_damage_ring_add_box(damage_ring(), box);
+	return schedule_frame();
+}
+
+Output & Output::damage_region(const pixman_region32_t * region) {
+	if (!region || !pixman_region32_not_empty(region)) {
+		return *this;
+	}
+
+	wlr_damage_ring_add(damage_ring(), region);
+	return schedule_frame();
+}
+
+Output & Output::damage_whole() {
+	wlr_damage_ring_add_whole(damage_ring());
+	return schedule_frame();
+}
+
+Output & Output::schedule_frame() {
+	_frame_requested = true;
+	wlr_output_schedule_frame(_wlr_output);
+	return *this;
+}
+
+Output & Output::request_redraw() {
+	return damage_whole();
+}
+
+Output & Output::add_input(Input * input, Nsec time) {
+	// one sample per device, its oldest event since the last commit that is still in time
+	for (auto & sample : _pending_inputs) {
+		if (sample.input == input) {
+			if (time - sample.time >= _input_cutoff()) {
+				sample.time = time;
+			}
+			return *this;
 		}
 	}
+	_pending_inputs.push_back({ input, time, 0 });
+	return *this;
+}
 
-	return nullptr;
+Output & Output::forget_input(Input * input) {
+	auto same = [input](const InputSample & sample) {
+		return sample.input == input;
+	};
+	std::erase_if(_pending_inputs, same);
+	std::erase_if(_tagged_inputs, same);
+	return *this;
+}
+
+bool Output::hit_test(Geo lx, Geo ly, WindowGrid::Hit * hit) {
+	if (!_current_workspace) {
+		return false;
+	}
+	// the workspace tree sits at the output position, windows are output-local
+	return _current_workspace->grid()->hit_test(lx - _x, ly - _y, hit);
+}
+
+Window * Output::window_at(Geo lx, Geo ly) {
+	WindowGrid::Hit hit;
+	return hit_test(lx, ly, &hit) ? hit.window : nullptr;
+}
+
+// scales an output-local logical box and applies the output transform, edges are rounded outwards
+struct wlr_box Output::buffer_box(const struct wlr_box * box) const {
+	double scale = _wlr_output->scale;
+	int x1 = static_cast<int>(std::floor(box->x * scale));
+	int y1 = static_cast<int>(std::floor(box->y * scale));
+	int x2 = static_cast<int>(std::ceil((box->x + box->width) * scale));
+	int y2 = static_cast<int>(std::ceil((box->y + box->height) * scale));
+	struct wlr_box scaled = {
+		.x = x1,
+		.y = y1,
+		.width = x2 - x1,
+		.height = y2 - y1,
+	};
+
+	int width, height;
+	wlr_output_transformed_resolution(_wlr_output, &width, &height);
+	struct wlr_box transformed;
+	wlr_box_transform(&transformed, &scaled, wlr_output_transform_invert(_wlr_output->transform), width, height);
+	return transformed;
 }
 
 struct Server * Output::server() const {
@@ -143,10 +279,115 @@ struct wl_event_source * Output::repaint_timer() const {
 	return _repaint_timer;
 }
 
+struct wlr_damage_ring * Output::damage_ring() {
+	if (_render_mode == RenderMode::SCENE) {
+		return &_scene_output->damage_ring;
+	}
+	return &_damage_ring;
+}
+
+bool Output::has_damage() const {
+	if (_render_mode == RenderMode::SCENE) {
+		return pixman_region32_not_empty(&_scene_output->damage_ring.current);
+	}
+	return pixman_region32_not_empty(&_damage_ring.current);
+}
+
+Render * Output::render() const {
+	return _render;
+}
+
+Geo Output::x() const {
+	return _x;
+}
+
+Geo Output::y() const {
+	return _y;
+}
+
+Output::RenderMode Output::render_mode() const {
+	return _render_mode;
+}
+
+Output::MaxRenderTime Output::max_render_time() const {
+	return _max_render_time;
+}
+
+Output::MaxRenderTime Output::render_budget() const {
+	if (_max_render_time != MAX_RENDER_TIME_AUTO) {
+		return _max_render_time;
+	}
+
+	// too few samples to trust, render right after the vblank
+	if (_n_render_durations < _render_durations.size() / 4 || _refresh_nsec <= 0) {
+		return MAX_RENDER_TIME_OFF;
+	}
+
+	Nsec worst = 0;
+	for (size_t i = 0; i < _n_render_durations; ++i) {
+		worst = std::max(worst, _render_durations[i]);
+	}
+
+	// round up and keep a millisecond of slack for the commit itself
+	Nsec budget = (worst + 999999) / 1000000 + 1;
+	Nsec refresh_msec = _refresh_nsec / 1000000;
+	if (budget >= refresh_msec) {
+		return MAX_RENDER_TIME_OFF;
+	}
+	// below the refresh interval in ms, well within range
+	return static_cast<MaxRenderTime>(budget);
+}
+
+bool Output::direct_scanout() const {
+	return _direct_scanout;
+}
+
+bool Output::scanned_out() const {
+	return _scanned_out;
+}
+
+bool Output::layer_offload() const {
+	return _layer_offload;
+}
+
+OutputLayers * Output::layers() const {
+	return _layers;
+}
+
+bool Output::tearing() const {
+	Window * window = _current_workspace ? _current_workspace->focused_window() : nullptr;
+	return window && window->mapped() && window->fullscreened() && window->allows_tearing();
+}
+
+Output::FramePacing Output::frame_pacing() const {
+	return _frame_pacing;
+}
+
+bool Output::adaptive_pacing() const {
+	return _frame_pacing == FramePacing::ADAPTIVE &&
+		_wlr_output->adaptive_sync_status == WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED;
+}
+
+Output::ModeRefresh Output::vrr_min_refresh() const {
+	return _vrr_min_refresh;
+}
+
+Output::ModeRefresh Output::vrr_max_refresh() const {
+	return _vrr_max_refresh > 0 ? _vrr_max_refresh : static_cast<ModeRefresh>(_wlr_output->refresh);
+}
+
+Nsec Output::content_interval() const {
+	return _content_interval;
+}
+
 struct timespec Output::last_frame() const {
 	return _last_frame;
 }
 
+struct timespec Output::last_presentation() const {
+	return _last_presentation;
+}
+
 Workspace * Output::current_workspace() const {
 	return _current_workspace;
 }
@@ -155,14 +396,38 @@ void * Output::data() const {
 	return _data;
 }
 
-std::list<Workspace*> Output::workspaces() const {
-	return _workspaces;
+std::span<Workspace * const> Output::workspaces() const {
+	return _workspaces.view();
 }
 
 WorkspacesHistory * Output::workspaces_history() const {
 	return _workspaces_history;
 }
 
+FrameStats * Output::frame_stats() const {
+	return _frame_stats;
+}
+
+LatencyHistogram * Output::input_latency() const {
+	return _input_latency;
+}
+
+Output::BudgetShare Output::budget_share() const {
+	return _budget_share;
+}
+
+uint32_t Output::budget_frames() const {
+	return _budget_frames;
+}
+
+bool Output::auto_degrade() const {
+	return _auto_degrade;
+}
+
+bool Output::degraded() const {
+	return _degraded;
+}
+
 const char * Output::name() const {
 	return _wlr_output->name;
 }
@@ -236,7 +501,7 @@ bool Output::needs_frame() const {
 }
 
 bool Output::frame_pending() const {
-	return _wlr_output->frame_pending;
+	return _wlr_output->frame_pending || _repaint_scheduled;
 }
 
 bool Output::non_desktop() const {
@@ -248,32 +513,159 @@ Output::CommitSeq Output::commit_seq() const {
 }
 
 Output & Output::switch_to_workspace(Workspace * workspace) {
+	if (_current_workspace && _current_workspace != workspace && _current_workspace->scene_tree()) {
+		wlr_scene_node_set_enabled(&_current_workspace->scene_tree()->node, false);
+	}
+
+	if (workspace->output() && workspace->output() != this) {
+		workspace->output()->remove_workspace(workspace);
+	}
+
 	_current_workspace = workspace;
+	_workspaces.insert(workspace);
 	_workspaces_history->shift(workspace);
 	workspace->set_output(this);
+	if (workspace->scene_tree()) {
+		wlr_scene_node_set_enabled(&workspace->scene_tree()->node, true);
+	}
+
+	damage_whole();
+	return *this;
+}
+
+Output & Output::remove_workspace(Workspace * workspace) {
+	if (!_workspaces.erase(workspace)) {
+		return *this;
+	}
+
+	_workspaces_history->remove(workspace);
+	if (_current_workspace == workspace) {
+		_current_workspace = nullptr;
+	}
 	return *this;
 }
 
 Output & Output::set_x(Geo x) {
 	_x = x;
+	wlr_output_layout_add(_server->root()->output_layout(), _wlr_output, static_cast<int>(_x), static_cast<int>(_y));
+	wlr_scene_output_set_position(_scene_output, static_cast<int>(_x), static_cast<int>(_y));
+	if (_current_workspace) {
+		_current_workspace->set_output(this);
+	}
 	return *this;
 }
 
 Output & Output::set_y(Geo y) {
 	_y = y;
+	wlr_output_layout_add(_server->root()->output_layout(), _wlr_output, static_cast<int>(_x), static_cast<int>(_y));
+	wlr_scene_output_set_position(_scene_output, static_cast<int>(_x), static_cast<int>(_y));
+	if (_current_workspace) {
+		_current_workspace->set_output(this);
+	}
 	return *this;
 }
 
-Output & Output::on_destroy(const Handler & handler) {
+Output & Output::set_render_mode(RenderMode mode) {
+	_render_mode = mode;
+	_n_render_durations = 0;
+	_render_durations_head = 0;
+	return damage_whole();
+}
+
+Output & Output::set_direct_scanout(bool enabled) {
+	_direct_scanout = enabled;
+	return schedule_frame();
+}
+
+Output & Output::set_layer_offload(bool enabled) {
+	_layer_offload = enabled;
+	if (!enabled) {
+		_layers->clear();
+	}
+	return damage_whole();
+}
+
+Output & Output::set_frame_pacing(FramePacing pacing) {
+	_frame_pacing = pacing;
+	_last_content_commit = 0;
+	_content_interval = 0;
+	wl_event_source_timer_update(_lfc_timer, 0);
+	_lfc_deadline = 0;
+	return *this;
+}
+
+Output & Output::set_vrr_range(ModeRefresh min_refresh, ModeRefresh max_refresh) {
+	_vrr_min_refresh = min_refresh;
+	_vrr_max_refresh = max_refresh;
+	return *this;
+}
+
+Output & Output::set_max_render_time(MaxRenderTime msec) {
+	_max_render_time = msec < MAX_RENDER_TIME_AUTO ? MAX_RENDER_TIME_OFF : msec;
+	return *this;
+}
+
+Output & Output::set_frame_budget(BudgetShare share, uint32_t frames) {
+	_budget_share = std::clamp(share, 0.0, 1.0);
+	_budget_frames = std::max<uint32_t>(frames, 1);
+	_over_budget = 0;
+	_within_budget = 0;
+	return *this;
+}
+
+Output & Output::set_auto_degrade(bool enabled) {
+	_auto_degrade = enabled;
+	if (!enabled) {
+		set_degraded(false);
+	}
+	return *this;
+}
+
+Output & Output::set_degraded(bool degraded) {
+	if (_degraded == degraded) {
+		return *this;
+	}
+
+	_degraded = degraded;
+	_within_budget = 0;
+	// effects come back or go away everywhere, not only where damage is
+	damage_whole();
+
+	_on_degrade.emit(this);
+	return *this;
+}
+
+Output & Output::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_destroy.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Output & Output::on_frame(const FrameHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_frame.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Output & Output::on_frame(const FrameHandler & handler) {
+Output & Output::on_frame_effect(const FrameHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_frame.push_back(std::move(handler));
+		_on_frame_effect.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Output & Output::on_over_budget(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_over_budget.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Output & Output::on_degrade(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_degrade.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -289,18 +681,474 @@ void Output::_handle_frame(struct wl_listener * listener, void * data) {
 	if (!wlr_output) {
 		return;
 	}
+	// a delayed repaint is already waiting for its deadline
+	if (output->_repaint_scheduled) {
+		return;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &output->_last_frame);
+
+	// with VRR or tearing the panel waits for us, delaying would only add latency
+	MaxRenderTime budget = output->adaptive_pacing() || output->tearing()
+		? MAX_RENDER_TIME_OFF
+		: output->render_budget();
+	int delay = 0;
+	if (budget > 0 && output->_refresh_nsec > 0 && output->_last_presentation.tv_sec > 0) {
+		Nsec now = timespec_to_nsec(output->_last_frame);
+		Nsec predicted = timespec_to_nsec(output->_last_presentation) + output->_refresh_nsec;
+		if (predicted < now) {
+			predicted += (now - predicted) / output->_refresh_nsec * output->_refresh_nsec
+				+ output->_refresh_nsec;
+		}
+		// at most one refresh interval ahead, the clamp only guards the narrowing
+		delay = static_cast<int>(std::clamp<Nsec>((predicted - now) / 1000000 - budget, 0, 1000));
+	}
+
+	// too close to the deadline to wait, or no budget set
+	if (delay < 1) {
+		output->_repaint();
+	}
+	else {
+		// hold back other frame events until the delayed repaint is done
+		output->_repaint_scheduled = true;
+		wl_event_source_timer_update(output->_repaint_timer, delay);
+		output->_repaint_deadline = monotonic_nsec() + static_cast<Nsec>(delay) * 1000000;
+	}
+
+	// clients draw their next buffer while we wait for the deadline
+	if (output->_render_mode == RenderMode::SCENE) {
+		wlr_scene_output_send_frame_done(output->_scene_output, &output->_last_frame);
+	}
+	else {
+		output->_send_frame_done();
+	}
+}
+
+void Output::_handle_present(struct wl_listener * listener, void * data) {
+	Output * output = wl_container_of(listener, output, _present_listener);
+	auto event = static_cast<struct wlr_output_event_present*>(data);
+	if (!event) {
+		return;
+	}
+
+	output->_frame_stats->record_present(
+		event->commit_seq, timespec_to_nsec(event->when), event->refresh, event->presented);
+	if (!event->presented) {
+		return;
+	}
+
+	output->_record_input_latency(event->commit_seq, timespec_to_nsec(event->when));
+
+	output->_last_presentation = event->when;
+	output->_refresh_nsec = event->refresh;
+}
+
+void Output::_handle_needs_frame(struct wl_listener * listener, void * data) {
+	Output * output = wl_container_of(listener, output, _needs_frame_listener);
+	wlr_output_schedule_frame(output->_wlr_output);
+}
+
+void Output::_handle_damage(struct wl_listener * listener, void * data) {
+	Output * output = wl_container_of(listener, output, _damage_listener);
+	auto event = static_cast<struct wlr_output_event_damage*>(data);
+
+	// the scene output listens for this itself
+	if (output->_render_mode == RenderMode::SCENE || !event) {
+		return;
+	}
+	output->damage_region(event->damage);
+}
+
+void Output::_repaint() {
+	bool damaged = has_damage() || _frame_requested;
+	bool pending = damaged || _wlr_output->needs_frame;
+	_frame_requested = false;
+	bool tearing = this->tearing();
+	Nsec start = monotonic_nsec();
+
+	FrameStats::Frame frame{};
+	frame.vblank = timespec_to_nsec(_last_frame);
+
+	// the scene graph tracks damage, picks direct scanout and renders by itself
+	if (_render_mode == RenderMode::SCENE) {
+		if (_commit_scene(tearing, false) && pending) {
+			_tag_inputs();
+			frame.commit = monotonic_nsec() - start;
+			frame.commit_seq = _wlr_output->commit_seq;
+			_frame_stats->record(frame);
+			_record_render_duration(frame.commit);
+			_frame_committed();
+		}
+		return;
+	}
+
+	// nothing changed since the last commit, keep the current buffer on screen
+	if (!pending) {
+		return;
+	}
+
+	Window * top = _current_workspace ? _current_workspace->focused_window() : nullptr;
+	if (_layer_offload) {
+		_layers->collect(top);
+	}
+	bool offloaded = _layer_offload && !_layers->empty();
+
+	// only the backend or the planes want a commit, e.g. a cursor move or a new video frame
+	if (!damaged && (!offloaded || _layers->all_accepted())) {
+		struct wlr_output_state state;
+		wlr_output_state_init(&state);
+		if (offloaded) {
+			_layers->apply(&state);
+			_layers->sample();
+		}
+		bool committed = wlr_output_commit_state(_wlr_output, &state);
+		wlr_output_state_finish(&state);
+		if (committed) {
+			_tag_inputs();
+		} else if (offloaded) {
+			damage_whole();
+		}
+		return;
+	}
+
+	if (_try_direct_scanout(tearing)) {
+		_tag_inputs();
+		frame.commit = monotonic_nsec() - start;
+		frame.commit_seq = _wlr_output->commit_seq;
+		_frame_stats->record(frame);
+		_frame_committed();
+		return;
+	}
+
+	_update_thumbnails();
 
 	struct wlr_buffer_pass_options pass_opts{};
-	auto render = new Render(output, &pass_opts, nullptr);
+	if (!_render->begin(&pass_opts)) {
+		return;
+	}
+
+	_render->state()->tearing_page_flip = tearing;
 
-	for (auto & cb : output->_on_frame) {
-		cb(output, wlr_output, render);
+	// the backend marks what it puts on planes, handlers skip those surfaces
+	if (_layer_offload) {
+		_layers->apply(_render->state());
+		wlr_output_test_state(_wlr_output, _render->state());
+		_layers->update_accepted();
 	}
 
-	render->commit();
-	delete render;
+	Nsec handler_start = monotonic_nsec();
+	_on_frame.emit(this, _wlr_output, _render);
+	// effects are drawn on top and are the first to go when frames run late
+	if (!_degraded) {
+		_on_frame_effect.emit(this, _wlr_output, _render);
+	}
+	frame.handler = monotonic_nsec() - handler_start;
+
+	_sample_windows(nullptr);
+
+	_render->commit();
+	if (_render->committed()) {
+		_tag_inputs();
+		frame.submit = _render->submit_duration();
+		frame.commit = _render->commit_duration();
+		frame.commit_seq = _wlr_output->commit_seq;
+		_frame_stats->record(frame);
+		_frame_committed();
+	}
+	_check_frame_budget(frame.handler + _render->submit_duration());
+
+	// GPU time of this pass is known only at the next one, the previous is close enough
+	Nsec duration = monotonic_nsec() - start;
+	if (_render->gpu_duration() > 0) {
+		duration += _render->gpu_duration();
+	}
+	_record_render_duration(duration);
 }
 
-int Output::_handle_repaint_timer(void * data) {
+bool Output::_commit_scene(bool tearing, bool force) {
+	if (!tearing && !force) {
+		return wlr_scene_output_commit(_scene_output, nullptr);
+	}
+
+	// wlr_scene_output_commit() has no tearing option and skips undamaged frames, build the state by hand.
+	// like it, skip the commit when nothing changed, or every commit would ask for the next frame
+	if (!force && !wlr_scene_output_needs_frame(_scene_output)) {
+		return true;
+	}
+
+	struct wlr_output_state state;
+	wlr_output_state_init(&state);
+	bool committed = false;
+	if (wlr_scene_output_build_state(_scene_output, &state, nullptr)) {
+		state.tearing_page_flip = tearing;
+		if (tearing && !wlr_output_test_state(_wlr_output, &state)) {
+			state.tearing_page_flip = false;
+		}
+		committed = wlr_output_commit_state(_wlr_output, &state);
+	}
+	wlr_output_state_finish(&state);
+	return committed;
+}
+
+bool Output::_try_direct_scanout(bool tearing) {
+	Window * window = _direct_scanout && _current_workspace ? _current_workspace->focused_window() : nullptr;
+	struct wlr_buffer * buffer = window ? window->scanout_buffer() : nullptr;
+	auto wlr_surface = buffer ? window->surface()->wlr_surface() : nullptr;
+
+	bool fits = wlr_surface &&
+		buffer->width == _wlr_output->width && buffer->height == _wlr_output->height &&
+		wlr_surface->current.transform == _wlr_output->transform &&
+		wlr_surface->current.scale == _wlr_output->scale &&
+		wlr_output_is_direct_scanout_allowed(_wlr_output);
+
+	bool committed = false;
+	if (fits) {
+		struct wlr_output_state state;
+		wlr_output_state_init(&state);
+		wlr_output_state_set_buffer(&state, buffer);
+		// KMS waits for the client's rendering on its own
+		auto syncobj = wlr_linux_drm_syncobj_v1_get_surface_state(wlr_surface);
+		if (syncobj && syncobj->acquire_timeline) {
+			wlr_output_state_set_wait_timeline(&state, syncobj->acquire_timeline, syncobj->acquire_point);
+		}
+		state.tearing_page_flip = tearing;
+		if (tearing && !wlr_output_test_state(_wlr_output, &state)) {
+			state.tearing_page_flip = false;
+		}
+		if (wlr_output_test_state(_wlr_output, &state)) {
+			window->sample(this, true);
+			committed = wlr_output_commit_state(_wlr_output, &state);
+		}
+		wlr_output_state_finish(&state);
+	}
+
+	if (committed) {
+		// the ring tracks composited buffers only, the client's one replaced them all
+		pixman_region32_clear(&_damage_ring.current);
+		_scanned_out = true;
+		return true;
+	}
+
+	if (_scanned_out) {
+		struct wlr_box box = {0, 0, _wlr_output->width, _wlr_output->height};
+		wlr_damage_ring_add_box(&_damage_ring, &box);
+		_scanned_out = false;
+	}
+	return false;
+}
+
+bool Output::_repeat_frame() {
+	// a scanned out client buffer is still the surface's current one
+	if (_scanned_out) {
+		return _try_direct_scanout(false);
+	}
+
+	auto buffer = _render->buffer();
+	if (!buffer) {
+		return false;
+	}
+
+	struct wlr_output_state state;
+	wlr_output_state_init(&state);
+	wlr_output_state_set_buffer(&state, buffer);
+	pixman_region32_t damage;
+	pixman_region32_init(&damage);
+	wlr_output_state_set_damage(&state, &damage);
+	pixman_region32_fini(&damage);
+	bool committed = wlr_output_commit_state(_wlr_output, &state);
+	wlr_output_state_finish(&state);
+	return committed;
+}
+
+void Output::_frame_committed(bool repeat) {
+	if (!adaptive_pacing() || _vrr_min_refresh == 0) {
+		return;
+	}
+
+	Nsec now = monotonic_nsec();
+	if (!repeat) {
+		if (_last_content_commit > 0) {
+			Nsec interval = now - _last_content_commit;
+			_content_interval = _content_interval > 0
+				? _content_interval + (interval - _content_interval) / 8
+				: interval;
+		}
+		_last_content_commit = now;
+	}
+
+	// low framerate compensation: show each frame k times so the panel stays in range
+	Nsec max_period = 1000000000000 / _vrr_min_refresh;
+	Nsec min_period = vrr_max_refresh() > 0 ? 1000000000000 / vrr_max_refresh() : 0;
+	Nsec period = max_period;
+	if (_content_interval > max_period) {
+		Nsec k = (_content_interval + max_period - 1) / max_period;
+		period = std::max(_content_interval / k, min_period);
+	}
 
+	int msec = static_cast<int>(std::max<Nsec>(1, period / 1000000));
+	wl_event_source_timer_update(_lfc_timer, msec);
+	_lfc_deadline = monotonic_nsec() + static_cast<Nsec>(msec) * 1000000;
+}
+
+void Output::_sample_windows(Window * scanned_out) {
+	if (!_current_workspace) {
+		return;
+	}
+
+	for (Window * window : *_current_workspace->windows_history()) {
+		window->sample(this, window == scanned_out);
+	}
+}
+
+void Output::_update_thumbnails() {
+	// a thumbnail is drawn in a pass of its own, which must not nest in the output's pass.
+	// only what the client committed since the last time, a late output keeps the old picture
+	for (auto workspace : _workspaces) {
+		for (Window * window : *workspace->windows_history()) {
+			auto thumbnail = window->thumbnail();
+			if (thumbnail && thumbnail->output() == this && thumbnail->dirty() &&
+				(!_degraded || !thumbnail->texture())
+			) {
+				thumbnail->update();
+			}
+		}
+	}
+}
+
+void Output::_send_frame_done() {
+	if (!_current_workspace) {
+		return;
+	}
+
+	for (Window * window : *_current_workspace->windows_history()) {
+		if (window->mapped()) {
+			window->send_frame_done(&_last_frame);
+		}
+	}
+}
+
+void Output::_record_render_duration(Nsec duration) {
+	_render_durations[_render_durations_head] = duration;
+	_render_durations_head = (_render_durations_head + 1) % _render_durations.size();
+	if (_n_render_durations < _render_durations.size()) {
+		++_n_render_durations;
+	}
+}
+
+void Output::_tag_inputs() {
+	if (_pending_inputs.empty()) {
+		return;
+	}
+
+	// nothing reacted to an input for this long, it is not a latency sample
+	Nsec now = monotonic_nsec();
+	Nsec cutoff = _input_cutoff();
+	for (auto & sample : _pending_inputs) {
+		if (now - sample.time < cutoff) {
+			sample.commit_seq = _wlr_output->commit_seq;
+			_tagged_inputs.push_back(sample);
+		}
+	}
+	_pending_inputs.clear();
+
+	// a backend without presentation feedback never resolves them
+	if (_tagged_inputs.size() > 64) {
+		_tagged_inputs.erase(_tagged_inputs.begin(), _tagged_inputs.end() - 64);
+	}
+}
+
+Nsec Output::_input_cutoff() const {
+	Nsec refresh = _refresh_nsec > 0 ? _refresh_nsec
+		: _wlr_output->refresh > 0 ? 1000000000000 / _wlr_output->refresh : 16666666;
+	return INPUT_LATENCY_FRAMES * refresh;
+}
+
+void Output::_record_input_latency(CommitSeq commit_seq, Nsec when) {
+	if (_tagged_inputs.empty()) {
+		return;
+	}
+
+	// a discarded frame hands its inputs over to the next presented one
+	Nsec oldest = 0;
+	std::erase_if(_tagged_inputs, [commit_seq, when, &oldest](const InputSample & sample) {
+		if (static_cast<int32_t>(commit_seq - sample.commit_seq) < 0) {
+			return false;
+		}
+		sample.input->latency()->add(when - sample.time);
+		if (!oldest || sample.time < oldest) {
+			oldest = sample.time;
+		}
+		return true;
+	});
+
+	if (oldest) {
+		_input_latency->add(when - oldest);
+	}
+}
+
+void Output::_check_frame_budget(Nsec spent) {
+	if (_budget_share <= 0.0) {
+		return;
+	}
+
+	Nsec refresh = _refresh_nsec > 0 ? _refresh_nsec
+		: _wlr_output->refresh > 0 ? 1000000000000 / _wlr_output->refresh : 0;
+	if (refresh <= 0) {
+		return;
+	}
+
+	if (static_cast<double>(spent) <= _budget_share * static_cast<double>(refresh)) {
+		_over_budget = 0;
+		// a cheaper degraded frame says little, wait for a steady stretch before going back
+		if (_degraded && _auto_degrade && ++_within_budget >= _budget_frames * 40) {
+			set_degraded(false);
+		}
+		return;
+	}
+
+	_within_budget = 0;
+	if (++_over_budget < _budget_frames) {
+		return;
+	}
+	_over_budget = 0;
+
+	_on_over_budget.emit(this);
+	if (_auto_degrade) {
+		set_degraded(true);
+	}
+}
+
+int Output::_handle_lfc_timer(void * data) {
+	auto output = static_cast<Output*>(data);
+	output->_server->loop_monitor()->record_timer(output->_lfc_deadline);
+	output->_lfc_deadline = 0;
+	if (!output->adaptive_pacing()) {
+		return 0;
+	}
+
+	// no new content in time, show the current frame again before the panel drops out of range.
+	// nothing is drawn, handlers do not run and the repeat is not a frame of its own
+	// a frame on its way is new content anyway
+	bool repeated = !output->frame_pending() && (output->_render_mode == RenderMode::SCENE
+		? output->_commit_scene(output->tearing(), true)
+		: output->_repeat_frame());
+	if (repeated) {
+		output->_frame_committed(true);
+		return 0;
+	}
+
+	// try again a refresh later
+	int msec = static_cast<int>(std::clamp<Nsec>(output->_refresh_nsec / 1000000, 1, 1000));
+	wl_event_source_timer_update(output->_lfc_timer, msec);
+	output->_lfc_deadline = monotonic_nsec() + static_cast<Nsec>(msec) * 1000000;
+	return 0;
+}
+
+int Output::_handle_repaint_timer(void * data) {
+	auto output = static_cast<Output*>(data);
+	output->_server->loop_monitor()->record_timer(output->_repaint_deadline);
+	output->_repaint_deadline = 0;
+	output->_repaint_scheduled = false;
+	output->_repaint();
+	return 0;
 }
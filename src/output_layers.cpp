@@ -0,0 +1,216 @@
+#include <algorithm>
+
+extern "C" {
+#include <wlr/types/wlr_linux_drm_syncobj_v1.h>
+#include <wlr/types/wlr_presentation_time.h>
+}
+
+#include "output.hpp"
+#include "window.hpp"
+#include "surface.hpp"
+#include "surface/xdg_toplevel.hpp"
+
+using namespace wlkit;
+
+OutputLayers::OutputLayers(Output * output):
+_output(output) {}
+
+OutputLayers::~OutputLayers() {
+	clear();
+}
+
+OutputLayers & OutputLayers::collect(Window * window) {
+	for (auto & entry : _entries) {
+		entry.used = false;
+	}
+
+	struct Visit {
+		OutputLayers * layers;
+		Window * window;
+		struct wlr_surface * root;
+		bool above_root;
+	} visit{ this, window, nullptr, false };
+
+	// walks back to front, only what is above the main surface may go to a plane above the primary
+	auto collect_surface = [](struct wlr_surface * surface, int sx, int sy, void * data) {
+		auto visit = static_cast<Visit*>(data);
+		if (surface == visit->root) {
+			visit->above_root = true;
+			return;
+		}
+		// planes do not rotate, the client has to render for the output's transform
+		auto output = visit->layers->_output;
+		if (!visit->above_root || !surface->buffer ||
+			surface->current.transform != output->wlr_output()->transform
+		) {
+			return;
+		}
+		// output layers carry no wait point, an explicitly synced buffer may still be in flight
+		auto syncobj = wlr_linux_drm_syncobj_v1_get_surface_state(surface);
+		if (syncobj && syncobj->acquire_timeline) {
+			return;
+		}
+
+		auto & entries = visit->layers->_entries;
+		auto it = std::find_if(entries.begin(), entries.end(), [surface](const Entry & entry) {
+			return entry.surface == surface;
+		});
+		if (it == entries.end()) {
+			auto layer = wlr_output_layer_create(output->wlr_output());
+			if (!layer) {
+				return;
+			}
+
+			entries.emplace_back();
+			it = std::prev(entries.end());
+			it->layers = visit->layers;
+			it->surface = surface;
+			it->layer = layer;
+			it->accepted = false;
+			it->commit_listener.notify = _handle_commit;
+			wl_signal_add(&surface->events.commit, &it->commit_listener);
+			it->destroy_listener.notify = _handle_destroy;
+			wl_signal_add(&surface->events.destroy, &it->destroy_listener);
+		}
+
+		// keep the entries in z order
+		entries.splice(entries.end(), entries, it);
+
+		it->used = true;
+		struct wlr_box box = {
+			.x = static_cast<int>(visit->window->x()) + sx,
+			.y = static_cast<int>(visit->window->y()) + sy,
+			.width = surface->current.width,
+			.height = surface->current.height,
+		};
+		it->box = output->buffer_box(&box);
+		wlr_surface_get_buffer_source_box(surface, &it->src_box);
+	};
+
+	if (window && window->mapped() && !window->minimized() && window->surface()) {
+		auto surface = window->surface();
+		visit.root = surface->wlr_surface();
+		if (surface->is_xdg_toplevel()) {
+			wlr_xdg_surface_for_each_surface(surface->as_xdg_toplevel()->xdg_surface(), collect_surface, &visit);
+		} else {
+			wlr_surface_for_each_surface(surface->wlr_surface(), collect_surface, &visit);
+		}
+	}
+
+	for (auto it = _entries.begin(); it != _entries.end(); ) {
+		auto entry = &*it++;
+		if (!entry->used) {
+			// whatever the plane showed has to be composited again
+			if (entry->accepted) {
+				_output->damage_buffer_box(&entry->box);
+			}
+			_remove(entry);
+		}
+	}
+
+	return *this;
+}
+
+OutputLayers & OutputLayers::apply(struct wlr_output_state * state) {
+	_states.clear();
+	for (auto & entry : _entries) {
+		_states.push_back({
+			.layer = entry.layer,
+			.buffer = &entry.surface->buffer->base,
+			.src_box = entry.src_box,
+			.dst_box = entry.box,
+			.damage = &entry.surface->buffer_damage,
+			.accepted = false,
+		});
+	}
+
+	wlr_output_state_set_layers(state, _states.data(), _states.size());
+	return *this;
+}
+
+OutputLayers & OutputLayers::update_accepted() {
+	auto state = _states.begin();
+	for (auto & entry : _entries) {
+		bool accepted = state != _states.end() && state->accepted;
+		if (state != _states.end()) {
+			++state;
+		}
+
+		// the buffer being rendered is already damaged, repair it with the next one
+		if (entry.accepted && !accepted) {
+			_output->damage_buffer_box(&entry.box);
+		}
+		entry.accepted = accepted;
+	}
+	return *this;
+}
+
+// a commit of the planes alone composites nothing, only the surfaces on planes get feedback
+OutputLayers & OutputLayers::sample() {
+	for (auto & entry : _entries) {
+		if (entry.accepted) {
+			wlr_presentation_surface_scanned_out_on_output(entry.surface, _output->wlr_output());
+		}
+	}
+	return *this;
+}
+
+OutputLayers & OutputLayers::clear() {
+	while (!_entries.empty()) {
+		_remove(&_entries.front());
+	}
+	_states.clear();
+	return *this;
+}
+
+bool OutputLayers::empty() const {
+	return _entries.empty();
+}
+
+bool OutputLayers::all_accepted() const {
+	for (auto & entry : _entries) {
+		if (!entry.accepted) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool OutputLayers::is_offloaded(struct wlr_surface * surface) const {
+	for (auto & entry : _entries) {
+		if (entry.surface == surface) {
+			return entry.accepted;
+		}
+	}
+	return false;
+}
+
+void OutputLayers::_remove(Entry * entry) {
+	wl_list_remove(&entry->commit_listener.link);
+	wl_list_remove(&entry->destroy_listener.link);
+	wlr_output_layer_destroy(entry->layer);
+	_entries.remove_if([entry](const Entry & e) {
+		return &e == entry;
+	});
+}
+
+void OutputLayers::_handle_commit(struct wl_listener * listener, void * data) {
+	Entry * entry = wl_container_of(listener, entry, commit_listener);
+	auto output = entry->layers->_output;
+
+	// a plane takes the new buffer without compositing, otherwise redraw its area
+	if (entry->accepted) {
+		wlr_output_schedule_frame(output->wlr_output());
+	} else {
+		output->damage_buffer_box(&entry->box);
+	}
+}
+
+void OutputLayers::_handle_destroy(struct wl_listener * listener, void * data) {
+	Entry * entry = wl_container_of(listener, entry, destroy_listener);
+	auto output = entry->layers->_output;
+	struct wlr_box box = entry->box;
+
+	entry->layers->_remove(entry);
+	output->damage_buffer_box(&box);
+}
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cmath>
+
+#include "overview.hpp"
+#include "output.hpp"
+#include "render.hpp"
+#include "workspace.hpp"
+#include "window.hpp"
+
+using namespace wlkit;
+
+Overview::Overview(Output * output, const Handler & callback):
+_output(output), _active(false), _gap(24), _selected(nullptr), _data(nullptr) {
+	if (!_output) {
+		// TODO error
+	}
+
+	if (callback) {
+		_on_create.push_back(std::move(callback));
+		callback(this);
+	}
+}
+
+Overview::~Overview() {
+	_on_destroy.emit(this);
+
+	if (_active) {
+		hide();
+	}
+}
+
+Overview & Overview::show() {
+	if (_active) {
+		return *this;
+	}
+
+	_active = true;
+	_collect();
+	_selected = _cells.empty() ? nullptr : _cells.front().window;
+	_output->damage_whole();
+
+	_on_show.emit(this);
+	return *this;
+}
+
+Overview & Overview::hide() {
+	if (!_active) {
+		return *this;
+	}
+
+	// the thumbnails stay cached in their windows, the next show reuses them
+	_collect();
+	for (auto & cell : _cells) {
+		if (auto thumbnail = cell.window->thumbnail()) {
+			thumbnail->show_on(nullptr);
+		}
+	}
+
+	_active = false;
+	_cells.clear();
+	_output->damage_whole();
+
+	_on_hide.emit(this);
+	return *this;
+}
+
+Overview & Overview::toggle() {
+	return _active ? hide() : show();
+}
+
+Overview & Overview::select(Window * window) {
+	if (_selected != window) {
+		_selected = window;
+		_output->damage_whole();
+	}
+	return *this;
+}
+
+Overview & Overview::select_next() {
+	_collect();
+	if (_cells.empty()) {
+		return select(nullptr);
+	}
+
+	auto it = std::find_if(_cells.begin(), _cells.end(), [this](const Cell & cell) {
+		return cell.window == _selected;
+	});
+	if (it == _cells.end() || ++it == _cells.end()) {
+		it = _cells.begin();
+	}
+	return select(it->window);
+}
+
+Overview & Overview::select_prev() {
+	_collect();
+	if (_cells.empty()) {
+		return select(nullptr);
+	}
+
+	auto it = std::find_if(_cells.begin(), _cells.end(), [this](const Cell & cell) {
+		return cell.window == _selected;
+	});
+	if (it == _cells.end() || it == _cells.begin()) {
+		it = _cells.end();
+	}
+	return select(std::prev(it)->window);
+}
+
+Overview & Overview::activate() {
+	_collect();
+	auto it = std::find_if(_cells.begin(), _cells.end(), [this](const Cell & cell) {
+		return cell.window == _selected;
+	});
+	Window * window = it != _cells.end() ? it->window : nullptr;
+
+	hide();
+	if (!window) {
+		return *this;
+	}
+
+	auto workspace = window->workspace();
+	if (workspace && workspace != _output->current_workspace()) {
+		_output->switch_to_workspace(workspace);
+	}
+	if (workspace) {
+		workspace->focus_window(window);
+	}
+
+	_on_activate.emit(this, window);
+	return *this;
+}
+
+Overview & Overview::draw(Render * render) {
+	if (!_active || !render->pass()) {
+		return *this;
+	}
+
+	auto wlr_output = _output->wlr_output();
+
+	struct wlr_render_rect_options background{};
+	background.box = { 0, 0, wlr_output->width, wlr_output->height };
+	background.color = { 0.0f, 0.0f, 0.0f, 0.6f };
+	render->draw_rect(background);
+
+	_collect();
+	_arrange();
+
+	for (auto & cell : _cells) {
+		auto thumbnail = cell.window->enable_thumbnail(cell.box.width, cell.box.height).thumbnail();
+		thumbnail->show_on(_output, &cell.box);
+		// the output redraws dirty thumbnails before its next pass begins, not inside this one
+		if (thumbnail->dirty()) {
+			_output->damage_buffer_box(&cell.box);
+		}
+		if (!thumbnail->texture()) {
+			continue;
+		}
+
+		struct wlr_render_texture_options opts{};
+		opts.texture = thumbnail->texture();
+		opts.src_box = { 0.0, 0.0, static_cast<double>(thumbnail->width()), static_cast<double>(thumbnail->height()) };
+		opts.dst_box = {
+			cell.box.x + (cell.box.width - thumbnail->width()) / 2,
+			cell.box.y + (cell.box.height - thumbnail->height()) / 2,
+			thumbnail->width(),
+			thumbnail->height(),
+		};
+		render->draw_texture(opts);
+
+		if (cell.window != _selected) {
+			continue;
+		}
+
+		int border = std::max(2, _gap / 8);
+		struct wlr_box box = opts.dst_box;
+		struct wlr_box edges[] = {
+			{ box.x - border, box.y - border, box.width + 2 * border, border },
+			{ box.x - border, box.y + box.height, box.width + 2 * border, border },
+			{ box.x - border, box.y, border, box.height },
+			{ box.x + box.width, box.y, border, box.height },
+		};
+		for (auto & edge : edges) {
+			struct wlr_render_rect_options rect{};
+			rect.box = edge;
+			rect.color = { 0.3f, 0.5f, 0.8f, 1.0f };
+			render->draw_rect(rect);
+		}
+	}
+
+	return *this;
+}
+
+Output * Overview::output() const {
+	return _output;
+}
+
+bool Overview::active() const {
+	return _active;
+}
+
+int Overview::gap() const {
+	return _gap;
+}
+
+Window * Overview::selected() const {
+	return _selected;
+}
+
+Window * Overview::window_at(Geo x, Geo y) const {
+	if (!_active) {
+		return nullptr;
+	}
+
+	auto scale = _output->get_scale();
+	int px = static_cast<int>((x - _output->x()) * scale);
+	int py = static_cast<int>((y - _output->y()) * scale);
+	for (auto & cell : _cells) {
+		if (wlr_box_contains_point(&cell.box, px, py)) {
+			return cell.window;
+		}
+	}
+	return nullptr;
+}
+
+const std::vector<Overview::Cell> & Overview::cells() const {
+	return _cells;
+}
+
+void * Overview::data() const {
+	return _data;
+}
+
+Overview & Overview::set_gap(int gap) {
+	_gap = std::max(0, gap);
+	if (_active) {
+		_output->damage_whole();
+	}
+	return *this;
+}
+
+Overview & Overview::set_data(void * data) {
+	_data = data;
+	return *this;
+}
+
+Overview & Overview::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_destroy.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Overview & Overview::on_show(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_show.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Overview & Overview::on_hide(const Handler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_hide.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+Overview & Overview::on_activate(const WindowHandler & handler, const char * name, Subscription * subscription) {
+	if (handler) {
+		_on_activate.push_back(std::move(handler), name, subscription);
+	}
+	return *this;
+}
+
+void Overview::_collect() {
+	_cells.clear();
+
+	// current workspace first, then by recent use, windows inside each by focus history
+	for (auto workspace : _output->workspaces_history()->history()) {
+		for (auto window : workspace->windows_history()->history()) {
+			if (window->mapped()) {
+				_cells.push_back({ window, {} });
+			}
+		}
+	}
+
+	if (_selected && std::none_of(_cells.begin(), _cells.end(), [this](const Cell & cell) {
+		return cell.window == _selected;
+	})) {
+		_selected = _cells.empty() ? nullptr : _cells.front().window;
+	}
+}
+
+void Overview::_arrange() {
+	if (_cells.empty()) {
+		return;
+	}
+
+	auto wlr_output = _output->wlr_output();
+	int cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(_cells.size()))));
+	int rows = static_cast<int>((_cells.size() + cols - 1) / cols);
+	int width = std::max(1, (wlr_output->width - _gap * (cols + 1)) / cols);
+	int height = std::max(1, (wlr_output->height - _gap * (rows + 1)) / rows);
+
+	for (size_t i = 0; i < _cells.size(); ++i) {
+		int col = static_cast<int>(i) % cols;
+		int row = static_cast<int>(i) / cols;
+		_cells[i].box = {
+			_gap + col * (width + _gap),
+			_gap + row * (height + _gap),
+			width,
+			height,
+		};
+	}
+}
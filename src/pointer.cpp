@@ -2,6 +2,8 @@
 #include "server.hpp"
 #include "surface.hpp"
 #include "seat.hpp"
+#include "root.hpp"
+#include "cursor.hpp"
 
 using namespace wlkit;
 
@@ -26,6 +28,8 @@ Input(server, Type::POINTER, device, callback) {
 	wl_signal_add(&_gestures->events.destroy, &_destroy_listener);
 	_motion_listener.notify = _handle_motion;
 	wl_signal_add(&_ptr->events.motion, &_motion_listener);
+	_motion_absolute_listener.notify = _handle_motion_absolute;
+	wl_signal_add(&_ptr->events.motion_absolute, &_motion_absolute_listener);
 	_button_listener.notify = _handle_button;
 	wl_signal_add(&_ptr->events.button, &_button_listener);
 	_axis_listener.notify = _handle_axis;
@@ -46,12 +50,14 @@ Input(server, Type::POINTER, device, callback) {
 	wl_signal_add(&_ptr->events.hold_begin, &_hold_begin_listener);
 	_hold_end_listener.notify = _handle_hold_end;
 	wl_signal_add(&_ptr->events.hold_end, &_hold_end_listener);
+
+	_server->root()->cursor()->attach(_device);
 }
 
 Pointer::~Pointer() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
+
+	_server->root()->cursor()->detach(_device);
 
 	// for (auto & pair : _constraints_by_surface) {
 	// 	free(pair->second);
@@ -143,86 +149,86 @@ struct wlr_pointer * Pointer::wlr_pointer() const {
 	return _ptr;
 }
 
-Pointer & Pointer::on_destroy(const Handler & handler) {
+Pointer & Pointer::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_motion(const MotionHandler & handler) {
+Pointer & Pointer::on_motion(const MotionHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_motion.push_back(std::move(handler));
+		_on_motion.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_button(const ButtonHandler & handler) {
+Pointer & Pointer::on_button(const ButtonHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_button.push_back(std::move(handler));
+		_on_button.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_axis(const AxisHandler & handler) {
+Pointer & Pointer::on_axis(const AxisHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_axis.push_back(std::move(handler));
+		_on_axis.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_swipe_begin(const ActionBeginHandler & handler) {
+Pointer & Pointer::on_swipe_begin(const ActionBeginHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_swipe_begin.push_back(std::move(handler));
+		_on_swipe_begin.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_swipe_update(const SwipeUpdateHandler & handler) {
+Pointer & Pointer::on_swipe_update(const SwipeUpdateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_swipe_update.push_back(std::move(handler));
+		_on_swipe_update.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_swipe_end(const ActionEndHandler & handler) {
+Pointer & Pointer::on_swipe_end(const ActionEndHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_swipe_end.push_back(std::move(handler));
+		_on_swipe_end.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_pinch_begin(const ActionBeginHandler & handler) {
+Pointer & Pointer::on_pinch_begin(const ActionBeginHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_pinch_begin.push_back(std::move(handler));
+		_on_pinch_begin.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_pinch_update(const PinchUpdateHandler & handler) {
+Pointer & Pointer::on_pinch_update(const PinchUpdateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_pinch_update.push_back(std::move(handler));
+		_on_pinch_update.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_pinch_end(const ActionEndHandler & handler) {
+Pointer & Pointer::on_pinch_end(const ActionEndHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_pinch_end.push_back(std::move(handler));
+		_on_pinch_end.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_hold_begin(const ActionBeginHandler & handler) {
+Pointer & Pointer::on_hold_begin(const ActionBeginHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_hold_begin.push_back(std::move(handler));
+		_on_hold_begin.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Pointer & Pointer::on_hold_end(const ActionEndHandler & handler) {
+Pointer & Pointer::on_hold_end(const ActionEndHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_hold_end.push_back(std::move(handler));
+		_on_hold_end.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -235,99 +241,98 @@ void Pointer::_handle_destroy(struct wl_listener * listener, void * data) {
 
 void Pointer::_handle_motion(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _motion_listener);
+	pointer->_stamp();
 	auto event = static_cast<struct wlr_pointer_motion_event*>(data);
 
- 	for (auto & cb : pointer->_on_motion) {
-		cb(pointer, event->delta_x, event->delta_y, event->unaccel_dx, event->unaccel_dy);
-	}
+	wlr_cursor_move(pointer->_server->root()->cursor()->wlr_cursor(),
+		&event->pointer->base, event->delta_x, event->delta_y);
+
+	pointer->_on_motion.emit(pointer, event->delta_x, event->delta_y, event->unaccel_dx, event->unaccel_dy);
+}
+
+void Pointer::_handle_motion_absolute(struct wl_listener * listener, void * data) {
+	Pointer * pointer = wl_container_of(listener, pointer, _motion_absolute_listener);
+	pointer->_stamp();
+	auto event = static_cast<struct wlr_pointer_motion_absolute_event*>(data);
+	auto cursor = pointer->_server->root()->cursor();
+
+	Geo x = cursor->x(), y = cursor->y();
+	wlr_cursor_warp_absolute(cursor->wlr_cursor(), &event->pointer->base, event->x, event->y);
+	Geo dx = cursor->x() - x, dy = cursor->y() - y;
+
+	pointer->_on_motion.emit(pointer, dx, dy, dx, dy);
 }
 
 void Pointer::_handle_button(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _button_listener);
+	pointer->_stamp();
 	auto event = static_cast<struct wlr_pointer_button_event*>(data);
 
- 	for (auto & cb : pointer->_on_button) {
-		cb(pointer, event->button, event->state == 1);
-	}
+	pointer->_on_button.emit(pointer, event->button, event->state == 1);
 }
 
 void Pointer::_handle_axis(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _axis_listener);
+	pointer->_stamp();
 	auto event = static_cast<struct wlr_pointer_axis_event*>(data);
 
- 	for (auto & cb : pointer->_on_axis) {
-		cb(pointer, event->source, event->orientation, event->relative_direction, event->delta, event->delta_discrete);
-	}
+	pointer->_on_axis.emit(pointer, event->source, event->orientation, event->relative_direction, event->delta, event->delta_discrete);
 }
 
 void Pointer::_handle_swipe_begin(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _swipe_begin_listener);
 	auto event = static_cast<struct wlr_pointer_swipe_begin_event*>(data);
 
- 	for (auto & cb : pointer->_on_swipe_begin) {
-		cb(pointer, event->fingers);
-	}
+	pointer->_on_swipe_begin.emit(pointer, event->fingers);
 }
 
 void Pointer::_handle_swipe_update(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _swipe_update_listener);
+	pointer->_stamp();
 	auto event = static_cast<struct wlr_pointer_swipe_update_event*>(data);
 
- 	for (auto & cb : pointer->_on_swipe_update) {
-		cb(pointer, event->fingers, event->dx, event->dy);
-	}
+	pointer->_on_swipe_update.emit(pointer, event->fingers, event->dx, event->dy);
 }
 
 void Pointer::_handle_swipe_end(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _swipe_end_listener);
 	auto event = static_cast<struct wlr_pointer_swipe_end_event*>(data);
 
- 	for (auto & cb : pointer->_on_swipe_end) {
-		cb(pointer, event->cancelled);
-	}
+	pointer->_on_swipe_end.emit(pointer, event->cancelled);
 }
 
 void Pointer::_handle_pinch_begin(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _pinch_begin_listener);
 	auto event = static_cast<struct wlr_pointer_pinch_begin_event*>(data);
 
- 	for (auto & cb : pointer->_on_pinch_begin) {
-		cb(pointer, event->fingers);
-	}
+	pointer->_on_pinch_begin.emit(pointer, event->fingers);
 }
 
 void Pointer::_handle_pinch_update(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _pinch_update_listener);
+	pointer->_stamp();
 	auto event = static_cast<struct wlr_pointer_pinch_update_event*>(data);
 
- 	for (auto & cb : pointer->_on_pinch_update) {
-		cb(pointer, event->fingers, event->dx, event->dy, event->scale, event->rotation);
-	}
+	pointer->_on_pinch_update.emit(pointer, event->fingers, event->dx, event->dy, event->scale, event->rotation);
 }
 
 void Pointer::_handle_pinch_end(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _pinch_end_listener);
 	auto event = static_cast<struct wlr_pointer_pinch_end_event*>(data);
 
- 	for (auto & cb : pointer->_on_pinch_end) {
-		cb(pointer, event->cancelled);
-	}
+	pointer->_on_pinch_end.emit(pointer, event->cancelled);
 }
 
 void Pointer::_handle_hold_begin(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _hold_begin_listener);
 	auto event = static_cast<struct wlr_pointer_hold_begin_event*>(data);
 
- 	for (auto & cb : pointer->_on_hold_begin) {
-		cb(pointer, event->fingers);
-	}
+	pointer->_on_hold_begin.emit(pointer, event->fingers);
 }
 
 void Pointer::_handle_hold_end(struct wl_listener * listener, void * data) {
 	Pointer * pointer = wl_container_of(listener, pointer, _hold_end_listener);
 	auto event = static_cast<struct wlr_pointer_hold_end_event*>(data);
 
- 	for (auto & cb : pointer->_on_hold_end) {
-		cb(pointer, event->cancelled);
-	}
+	pointer->_on_hold_end.emit(pointer, event->cancelled);
 }
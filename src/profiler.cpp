@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "handler_list.hpp"
+
+using namespace wlkit;
+
+// records join on their first profiled call, idle handlers never show up
+static struct wl_list records = { &records, &records };
+
+Profiler::Record::Record(const char * list, const char * name, size_t index):
+_list(list), _calls(0), _total(0), _worst(0) {
+	_name = name ? name : "#" + std::to_string(index);
+	wl_list_init(&_link);
+}
+
+Profiler::Record::~Record() {
+	wl_list_remove(&_link);
+}
+
+void Profiler::Record::add(Nsec duration) {
+	if (wl_list_empty(&_link)) {
+		wl_list_insert(records.prev, &_link);
+	}
+
+	++_calls;
+	_total += duration;
+	_worst = std::max(_worst, duration);
+}
+
+void Profiler::set_enabled(bool enabled) {
+	_enabled = enabled;
+}
+
+std::vector<Profiler::Entry> Profiler::report() {
+	std::vector<Entry> entries;
+
+	Record * record;
+	wl_list_for_each(record, &records, _link) {
+		entries.push_back({ record->_list, record->_name, record->_calls, record->_total, record->_worst });
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+		return a.worst > b.worst;
+	});
+	return entries;
+}
+
+void Profiler::reset() {
+	Record * record, * tmp;
+	wl_list_for_each_safe(record, tmp, &records, _link) {
+		record->_calls = 0;
+		record->_total = 0;
+		record->_worst = 0;
+		wl_list_remove(&record->_link);
+		wl_list_init(&record->_link);
+	}
+}
+
+void Profiler::log(enum wlr_log_importance verbosity) {
+	for (auto & entry : report()) {
+		wlr_log(verbosity, "%s %s: %llu calls, %.3f ms total, %.3f ms avg, %.3f ms worst",
+			entry.list, entry.name.c_str(),
+			static_cast<unsigned long long>(entry.calls),
+			static_cast<double>(entry.total) / 1e6,
+			entry.calls ? static_cast<double>(entry.total) / static_cast<double>(entry.calls) / 1e6 : 0.0,
+			static_cast<double>(entry.worst) / 1e6);
+	}
+}
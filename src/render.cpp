@@ -1,43 +1,34 @@
+extern "C" {
+#include <wlr/types/wlr_linux_drm_syncobj_v1.h>
+}
+
 #include "render.hpp"
 #include "output.hpp"
+#include "server.hpp"
 
 using namespace wlkit;
 
-Render::Render(Output * output, struct wlr_buffer_pass_options * pass_opts, const Handler & callback):
-_output(output), _data(nullptr) {
-	if (!_output || !_output->wlr_output() || !pass_opts) {
+Render::Render(Output * output, const Handler & callback):
+_output(output), _pass(nullptr), _buffer(nullptr), _timer(nullptr), _timeline(nullptr), _timeline_point(0),
+_timer_pending(false), _gpu_duration(-1),
+_submit_duration(0), _commit_duration(0), _committed(false), _data(nullptr) {
+	if (!_output || !_output->wlr_output()) {
 		// TODO error
 	}
 
-	_state = new wlr_output_state{};
-	wlr_output_state_init(_state);
-
-	pixman_region32_t buffer_damage;
-	pixman_region32_init(&buffer_damage);
-
-	// bool needs_frame;
-	// if (!wlr_output_damage_attach_render(output->damage, &needs_frame, &buffer_damage)) {
-	// 	wlr_output_state_finish(_state);
-	// 	pixman_region32_fini(&buffer_damage);
-	// 	free(_state);
-	// 	// TODO error
-	// }
-
-	// if (!needs_frame) {
-	//	wlr_output_rollback(output->wlr_output);
-	// 	wlr_output_state_finish(_state);
-	// 	pixman_region32_fini(&buffer_damage);
-	// 	free(_state);
-	// }
+	// not every renderer can time its passes, the timer stays null then
+	_timer = wlr_render_timer_create(_output->server()->renderer());
 
-	_pass = wlr_output_begin_render_pass(_output->wlr_output(), _state, pass_opts);
-	if (!_pass) {
-		wlr_output_state_finish(_state);
-		pixman_region32_fini(&buffer_damage);
-		free(_state);
-		// TODO error
+	// the pass signals this timeline and KMS waits on it, no CPU stall on the GPU work
+	auto server = _output->server();
+	if (server->drm_syncobj_manager() && _output->wlr_output()->backend->features.timeline) {
+		_timeline = wlr_drm_syncobj_timeline_create(wlr_renderer_get_drm_fd(server->renderer()));
 	}
 
+	wlr_output_state_init(&_state);
+	pixman_region32_init(&_frame_damage);
+	pixman_region32_init(&_buffer_damage);
+
 	_destroy_listener.notify = _handle_destroy;
 
 	if (callback) {
@@ -47,32 +38,160 @@ _output(output), _data(nullptr) {
 }
 
 Render::~Render() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
+	_on_destroy.emit(this);
+
+	if (_buffer) {
+		wlr_buffer_unlock(_buffer);
+	}
+	if (_timer) {
+		wlr_render_timer_destroy(_timer);
+	}
+	if (_timeline) {
+		wlr_drm_syncobj_timeline_unref(_timeline);
+	}
+	wlr_output_state_finish(&_state);
+	pixman_region32_fini(&_buffer_damage);
+	pixman_region32_fini(&_frame_damage);
+}
+
+bool Render::begin(struct wlr_buffer_pass_options * pass_opts) {
+	// the state is reused between frames, drop what the previous one left
+	wlr_output_state_finish(&_state);
+	wlr_output_state_init(&_state);
+	_pass = nullptr;
+	_submit_duration = 0;
+	_commit_duration = 0;
+	_committed = false;
+
+	// the previous pass is long finished on the GPU by now
+	if (_timer_pending) {
+		int duration = wlr_render_timer_get_duration_ns(_timer);
+		_gpu_duration = duration >= 0 ? duration : -1;
+		_timer_pending = false;
+	}
+	if (_timer && !pass_opts->timer) {
+		pass_opts->timer = _timer;
+	}
+	bool signal = _timeline && !pass_opts->signal_timeline;
+	if (signal) {
+		pass_opts->signal_timeline = _timeline;
+		pass_opts->signal_point = ++_timeline_point;
+	}
+
+	auto damage_ring = _output->damage_ring();
+	pixman_region32_copy(&_frame_damage, &damage_ring->current);
+
+	_pass = wlr_output_begin_render_pass(_output->wlr_output(), &_state, pass_opts);
+	if (!_pass) {
+		// the damage stays in the ring, try again on the next frame
+		_output->schedule_frame();
+		// TODO error
+		return false;
 	}
 
-	delete _state;
+	// region of the acquired buffer that is stale, accounting for its age
+	wlr_damage_ring_rotate_buffer(damage_ring, _state.buffer, &_buffer_damage);
+	wlr_output_state_set_damage(&_state, &_frame_damage);
+	if (signal) {
+		wlr_output_state_set_wait_timeline(&_state, _timeline, _timeline_point);
+	}
+
+	return true;
+}
+
+Render & Render::draw(DisplayList & list) {
+	if (!_pass) {
+		return *this;
+	}
+
+	// a late output repaints only what is stale in the buffer
+	auto clip = _output->degraded() ? &_buffer_damage : nullptr;
+	list.submit(_pass, static_cast<int>(_output->width()), static_cast<int>(_output->height()), clip);
+	return *this;
+}
+
+Render & Render::draw_rect(struct wlr_render_rect_options opts) {
+	if (!_pass || !_clip(opts.box, &opts.clip)) {
+		return *this;
+	}
+
+	wlr_render_pass_add_rect(_pass, &opts);
+	return *this;
+}
+
+Render & Render::draw_texture(struct wlr_render_texture_options opts) {
+	if (!_pass || !opts.texture || !_clip(opts.dst_box, &opts.clip)) {
+		return *this;
+	}
+
+	wlr_render_pass_add_texture(_pass, &opts);
+	return *this;
+}
+
+Render & Render::draw_surface(struct wlr_surface * surface, struct wlr_render_texture_options opts) {
+	if (!_pass || !surface) {
+		return *this;
+	}
+
+	if (!opts.texture) {
+		opts.texture = wlr_surface_get_texture(surface);
+	}
+	if (!opts.texture) {
+		return *this;
+	}
+
+	if (!_clip(opts.dst_box, &opts.clip)) {
+		return *this;
+	}
+
+	wait_for_surface(surface, &opts);
+	wlr_render_pass_add_texture(_pass, &opts);
+	return *this;
 }
 
 Render & Render::commit() {
-	if (!_output || !_output->wlr_output()) {
+	if (!_output || !_output->wlr_output() || !_pass) {
 		return *this;
 	}
 	auto wlr_output = _output->wlr_output();
 
-	wlr_output_add_software_cursors_to_render_pass(wlr_output, _pass, nullptr);
+	wlr_output_add_software_cursors_to_render_pass(wlr_output, _pass, &_buffer_damage);
 
-	if (!wlr_render_pass_submit(_pass)) {
-		wlr_output_state_finish(_state);
+	Nsec start = monotonic_nsec();
+	bool submitted = wlr_render_pass_submit(_pass);
+	_submit_duration = monotonic_nsec() - start;
+	_pass = nullptr;
+	_timer_pending = submitted && _timer;
+	if (!submitted) {
+		_output->damage_region(&_frame_damage);
+		wlr_output_state_finish(&_state);
+		wlr_output_state_init(&_state);
 		// TODO error
+		return *this;
 	}
 
-	if (!wlr_output_commit_state(wlr_output, _state)) {
+	// async flips are a hint, not every backend or plane config takes them
+	if (_state.tearing_page_flip && !wlr_output_test_state(wlr_output, &_state)) {
+		_state.tearing_page_flip = false;
+	}
+
+	start = monotonic_nsec();
+	_committed = wlr_output_commit_state(wlr_output, &_state);
+	_commit_duration = monotonic_nsec() - start;
+	if (_committed) {
+		// kept to show the frame again without drawing it
+		if (_buffer) {
+			wlr_buffer_unlock(_buffer);
+		}
+		_buffer = wlr_buffer_lock(_state.buffer);
+	} else {
+		_output->damage_region(&_frame_damage);
 		// TODO error
 	}
 
-	wlr_output_schedule_frame(wlr_output);
-	wlr_output_state_finish(_state);
+	// release the buffer right away, the output holds its own reference
+	wlr_output_state_finish(&_state);
+	wlr_output_state_init(&_state);
 
 	return *this;
 }
@@ -81,17 +200,81 @@ Output * Render::output() const {
 	return _output;
 }
 
-struct wlr_output_state * Render::state() const {
-	return _state;
+struct wlr_output_state * Render::state() {
+	return &_state;
 }
 
 struct wlr_render_pass * Render::pass() const {
 	return _pass;
 }
 
-Render & Render::on_destroy(const Handler & handler) {
+struct wlr_buffer * Render::buffer() const {
+	return _buffer;
+}
+
+const pixman_region32_t * Render::damage() const {
+	return &_buffer_damage;
+}
+
+Nsec Render::gpu_duration() const {
+	return _gpu_duration;
+}
+
+Nsec Render::submit_duration() const {
+	return _submit_duration;
+}
+
+Nsec Render::commit_duration() const {
+	return _commit_duration;
+}
+
+bool Render::committed() const {
+	return _committed;
+}
+
+bool Render::is_offloaded(struct wlr_surface * surface) const {
+	return _output->layer_offload() && _output->layers()->is_offloaded(surface);
+}
+
+bool Render::is_damaged(const struct wlr_box & box) const {
+	pixman_box32_t extents = { box.x, box.y, box.x + box.width, box.y + box.height };
+	return pixman_region32_contains_rectangle(&_buffer_damage, &extents) != PIXMAN_REGION_OUT;
+}
+
+struct wlr_drm_syncobj_timeline * Render::timeline() const {
+	return _timeline;
+}
+
+uint64_t Render::timeline_point() const {
+	return _timeline_point;
+}
+
+// a late output repaints only what is stale in the buffer, false when the box is not stale at all
+bool Render::_clip(const struct wlr_box & box, const pixman_region32_t ** clip) const {
+	if (!_output->degraded()) {
+		return true;
+	}
+	if (!is_damaged(box)) {
+		return false;
+	}
+	if (!*clip) {
+		*clip = &_buffer_damage;
+	}
+	return true;
+}
+
+void Render::wait_for_surface(struct wlr_surface * surface, struct wlr_render_texture_options * opts) {
+	// the client's GPU work may still be running, the pass waits for it instead of the CPU
+	auto syncobj = wlr_linux_drm_syncobj_v1_get_surface_state(surface);
+	if (syncobj && syncobj->acquire_timeline) {
+		opts->wait_timeline = syncobj->acquire_timeline;
+		opts->wait_point = syncobj->acquire_point;
+	}
+}
+
+Render & Render::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -24,10 +24,12 @@ _server(server), _x(0), _y(0), _width(0), _height(0), _data(nullptr) {
 
 	bool failed = false;
 	_staging = Node::alloc_scene_tree(&_scene->tree, &failed);
+	_workspace_tree = Node::alloc_scene_tree(&_scene->tree, &failed);
 	_layer_tree = Node::alloc_scene_tree(&_scene->tree, &failed);
 	if (failed) {
 		// TODO error
 	}
+	wlr_scene_node_set_enabled(&_staging->node, false);
 
 	_destroy_listener.notify = _handle_destroy;
 	wl_signal_add(&_output_layout->events.destroy, &_destroy_listener);
@@ -45,9 +47,7 @@ _server(server), _x(0), _y(0), _width(0), _height(0), _data(nullptr) {
 }
 
 Root::~Root() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
 	delete _cursor;
 	delete _node;
@@ -67,6 +67,10 @@ struct wlr_scene_tree * Root::staging() const {
 	return _staging;
 }
 
+struct wlr_scene_tree * Root::workspace_tree() const {
+	return _workspace_tree;
+}
+
 struct wlr_scene_tree * Root::layer_tree() const {
 	return _layer_tree;
 }
@@ -87,9 +91,13 @@ Geo Root::height() const {
 	return _height;
 }
 
-Root & Root::on_destroy(const Handler & handler) {
+Cursor * Root::cursor() const {
+	return _cursor;
+}
+
+Root & Root::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
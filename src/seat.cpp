@@ -237,100 +237,100 @@ struct wlr_seat_client * Seat::wlr_seat_client() const {
 	return _wlr_seat_client;
 }
 
-Seat & Seat::on_destroy(const Handler & handler) {
+Seat & Seat::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(handler);
+		_on_destroy.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_pointer_grab_begin(const Handler & handler) {
+Seat & Seat::on_pointer_grab_begin(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_pointer_grab_begin.push_back(handler);
+		_on_pointer_grab_begin.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_pointer_grab_end(const Handler & handler) {
+Seat & Seat::on_pointer_grab_end(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_pointer_grab_end.push_back(handler);
+		_on_pointer_grab_end.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_keyboard_grab_begin(const Handler & handler) {
+Seat & Seat::on_keyboard_grab_begin(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_keyboard_grab_begin.push_back(handler);
+		_on_keyboard_grab_begin.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_keyboard_grab_end(const Handler & handler) {
+Seat & Seat::on_keyboard_grab_end(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_keyboard_grab_end.push_back(handler);
+		_on_keyboard_grab_end.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_touch_grab_begin(const Handler & handler) {
+Seat & Seat::on_touch_grab_begin(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_touch_grab_begin.push_back(handler);
+		_on_touch_grab_begin.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_touch_grab_end(const Handler & handler) {
+Seat & Seat::on_touch_grab_end(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_touch_grab_end.push_back(handler);
+		_on_touch_grab_end.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_request_set_cursor(const RequestSetCursorHandler & handler) {
+Seat & Seat::on_request_set_cursor(const RequestSetCursorHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_request_set_cursor.push_back(handler);
+		_on_request_set_cursor.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_request_set_selection(const RequestSetSelectionHandler & handler) {
+Seat & Seat::on_request_set_selection(const RequestSetSelectionHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_request_set_selection.push_back(handler);
+		_on_request_set_selection.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_set_selection(const Handler & handler) {
+Seat & Seat::on_set_selection(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_set_selection.push_back(handler);
+		_on_set_selection.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_request_set_primary_selection(const RequestSetPrimarySelectionHandler & handler) {
+Seat & Seat::on_request_set_primary_selection(const RequestSetPrimarySelectionHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_request_set_primary_selection.push_back(handler);
+		_on_request_set_primary_selection.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_set_primary_selection(const Handler & handler) {
+Seat & Seat::on_set_primary_selection(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_set_primary_selection.push_back(handler);
+		_on_set_primary_selection.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_request_start_drag(const RequestStartDragHandler & handler) {
+Seat & Seat::on_request_start_drag(const RequestStartDragHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_request_start_drag.push_back(handler);
+		_on_request_start_drag.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Seat & Seat::on_start_drag(const StartDragHandler & handler) {
+Seat & Seat::on_start_drag(const StartDragHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_start_drag.push_back(handler);
+		_on_start_drag.push_back(handler, name, subscription);
 	}
 	return *this;
 }
@@ -342,107 +342,81 @@ void Seat::_handle_destroy(struct ::wl_listener * listener, void * data) {
 
 void Seat::_handle_pointer_grab_begin(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 }
 
 void Seat::_handle_pointer_grab_end(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_keyboard_grab_begin(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_keyboard_grab_end(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_touch_grab_begin(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_touch_grab_end(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_request_set_cursor(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _request_set_cursor_listener);
 	auto event = static_cast<struct wlr_seat_pointer_request_set_cursor_event*>(data);
-	for (auto & cb : seat->_on_request_set_cursor) {
-		cb(seat, event);
-	}
+	seat->_on_request_set_cursor.emit(seat, event);
 
 }
 
 void Seat::_handle_request_set_selection(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _request_set_selection_listener);
 	auto event = static_cast<struct wlr_seat_request_set_selection_event*>(data);
-	for (auto & cb : seat->_on_request_set_selection) {
-		cb(seat, event);
-	}
+	seat->_on_request_set_selection.emit(seat, event);
 
 }
 
 void Seat::_handle_set_selection(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _destroy_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_request_set_primary_selection(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _request_set_primary_selection_listener);
 	auto event = static_cast<struct wlr_seat_request_set_primary_selection_event*>(data);
-	for (auto & cb : seat->_on_request_set_primary_selection) {
-		cb(seat, event);
-	}
+	seat->_on_request_set_primary_selection.emit(seat, event);
 
 }
 
 void Seat::_handle_set_primary_selection(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _set_primary_selection_listener);
-	for (auto & cb : seat->_on_pointer_grab_begin) {
-		cb(seat);
-	}
+	seat->_on_pointer_grab_begin.emit(seat);
 
 }
 
 void Seat::_handle_request_start_drag(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _request_start_drag_listener);
 	auto event = static_cast<struct wlr_seat_request_start_drag_event*>(data);
-	for (auto & cb : seat->_on_request_start_drag) {
-		cb(seat, event);
-	}
+	seat->_on_request_start_drag.emit(seat, event);
 
 }
 
 void Seat::_handle_start_drag(struct ::wl_listener * listener, void * data) {
 	Seat * seat = wl_container_of(listener, seat, _start_drag_listener);
 	auto drag = static_cast<struct wlr_drag*>(data);
-	for (auto & cb : seat->_on_start_drag) {
-		cb(seat, drag);
-	}
+	seat->_on_start_drag.emit(seat, drag);
 }
@@ -18,15 +18,17 @@ extern "C" {
 
 using namespace wlkit;
 
-Server::Server(Seat * seat, const Handler & callback):
-_seat(seat), _running(false), _data(nullptr) {
+Server::Server(Seat * seat, const Handler & callback, const char * backends):
+_seat(seat), _running(false), _preferred_output(nullptr), _data(nullptr) {
 	if (!_seat) {
 		// TODO error
 	}
 
 	_inside_wl = getenv("WAYLAND_DISPLAY") ||
 		(getenv("XDG_SESSION_TYPE") && strcmp(getenv("XDG_SESSION_TYPE"), "wayland") == 0);
-	if (_inside_wl) {
+	if (backends) {
+		setenv("WLR_BACKENDS", backends, true);
+	} else if (_inside_wl) {
 		setenv("WLR_BACKENDS", "wayland", true);
 	} else {
 		setenv("WLR_BACKENDS", "drm,libinput", true);
@@ -79,6 +81,8 @@ _seat(seat), _running(false), _data(nullptr) {
 	wl_signal_add(&_compositor->events.destroy, &_destroy_listener);
 
 	_root = new Root(this, nullptr, 24, nullptr);  // TODO from config
+	_loop_monitor = new LoopMonitor(this);
+	_windows_history = new WindowsHistory();
 
 	_data_device_manager = wlr_data_device_manager_create(_display);
 
@@ -134,11 +138,13 @@ _seat(seat), _running(false), _data(nullptr) {
 	if (wlr_renderer_get_texture_formats(_renderer, WLR_BUFFER_CAP_DMABUF) != nullptr) {
 		_linux_dmabuf = wlr_linux_dmabuf_v1_create_with_renderer(_display, 4, _renderer);
 	}
+	// explicit sync needs timelines on both sides, Render checks the manager before using them
+	_drm_syncobj_manager = nullptr;
 	if (wlr_renderer_get_drm_fd(_renderer) >= 0 &&
 		_renderer->features.timeline &&
 		_backend->features.timeline
 	) {
-		wlr_linux_drm_syncobj_manager_v1_create(_display, 1, wlr_renderer_get_drm_fd(_renderer));
+		_drm_syncobj_manager = wlr_linux_drm_syncobj_manager_v1_create(_display, 1, wlr_renderer_get_drm_fd(_renderer));
 	}
 
 	_xdg_activation = wlr_xdg_activation_v1_create(_display);
@@ -166,6 +172,8 @@ _seat(seat), _running(false), _data(nullptr) {
 	// wl_signal_add(&_idle_inhibit_manager_v1->wlr_manager->events.destroy, &_idle_inhibit_manager_v1->manager_destroy);
 
 	_ext_output_image_capture_source_manager = wlr_ext_output_image_capture_source_manager_v1_create(_display, 1);
+	_tearing_control_manager = wlr_tearing_control_manager_v1_create(_display, 1);
+	_presentation = wlr_presentation_create(_display, _backend, 2);
 
 	if (callback) {
 		_on_create.push_back(std::move(callback));
@@ -174,18 +182,16 @@ _seat(seat), _running(false), _data(nullptr) {
 }
 
 Server::~Server() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
+	delete _windows_history;
+	delete _loop_monitor;
 	// TODO cleanup
 }
 
 Workspace * Server::get_workspace_by_id(Workspace::ID id) {
-	auto workspace = std::find_if(_workspaces.begin(), _workspaces.end(), [=](auto ws) {
-		return ws->id() == id;
-	});
-	return workspace == _workspaces.end() ? nullptr : *workspace;
+	auto it = _workspaces_by_id.find(id);
+	return it == _workspaces_by_id.end() ? nullptr : it->second;
 }
 
 Server & Server::start() {
@@ -201,20 +207,17 @@ Server & Server::start() {
 	setenv("WAYLAND_DISPLAY", _socket_id, true);
 	wlr_log(WLR_INFO, "Running wlkit on WAYLAND_DISPLAY=%s", _socket_id);
 
-	for (auto & cb : _on_start) {
-		cb(this);
-	}
+	_on_start.emit(this);
 
+	// wl_display_run() with the wait and the dispatch split, so the loop can be measured
 	_running = true;
-	wl_display_run(_display);
+	while (_running && _loop_monitor->run()) {}
 
 	return *this;
 }
 
 Server & Server::stop() {
-	for (auto & cb : _on_stop) {
-		cb(this);
-	}
+	_on_stop.emit(this);
 
 	_running = false;
 	wl_display_terminate(_display);
@@ -223,22 +226,54 @@ Server & Server::stop() {
 }
 
 Server & Server::add_workspace(Workspace * workspace) {
-	_workspaces.push_back(workspace);
+	if (_workspaces.insert(workspace)) {
+		// the first workspace registered with an id keeps it
+		_workspaces_by_id.emplace(workspace->id(), workspace);
+	}
 	return *this;
 }
 
 Server & Server::add_window(Window * window) {
-	_windows.push_back(window);
+	if (_windows.insert(window)) {
+		_windows_history->push_back(window);
+	}
 	return *this;
 }
 
 Server & Server::remove_workspace(Workspace * workspace) {
-	_workspaces.remove(workspace);
+	if (!_workspaces.erase(workspace)) {
+		return *this;
+	}
+
+	auto it = _workspaces_by_id.find(workspace->id());
+	if (it != _workspaces_by_id.end() && it->second == workspace) {
+		_workspaces_by_id.erase(it);
+		for (auto other : _workspaces) {
+			if (other->id() == workspace->id()) {
+				_workspaces_by_id.emplace(other->id(), other);
+				break;
+			}
+		}
+	}
 	return *this;
 }
 
 Server & Server::remove_window(Window * window) {
-	_windows.remove(window);
+	_windows.erase(window);
+	_windows_history->remove(window);
+	return *this;
+}
+
+Server & Server::remove_output(Output * output) {
+	_outputs.erase(output);
+	if (_preferred_output == output) {
+		_preferred_output = _outputs.empty() ? nullptr : _outputs.front();
+	}
+	return *this;
+}
+
+Server & Server::remove_input(Input * input) {
+	_inputs.erase(input);
 	return *this;
 }
 
@@ -303,87 +338,117 @@ void * Server::data() const {
 	return _data;
 }
 
-std::list<Output*> Server::outputs() const {
-	return _outputs;
+std::span<Output * const> Server::outputs() const {
+	return _outputs.view();
 }
 
-std::list<Input*> Server::inputs() const {
-	return _inputs;
+Output * Server::output_at(Geo x, Geo y) const {
+	auto wlr_output = wlr_output_layout_output_at(_root->output_layout(), x, y);
+	if (!wlr_output) {
+		return nullptr;
+	}
+
+	for (auto output : _outputs) {
+		if (output->wlr_output() == wlr_output) {
+			return output;
+		}
+	}
+	return nullptr;
+}
+
+std::span<Input * const> Server::inputs() const {
+	return _inputs.view();
 }
 
-std::list<Workspace*> Server::workspaces() const {
-	return _workspaces;
+std::span<Workspace * const> Server::workspaces() const {
+	return _workspaces.view();
 }
 
-std::list<Window*> Server::windows() const {
-	return _windows;
+std::span<Window * const> Server::windows() const {
+	return _windows.view();
 }
 
 WindowsHistory * Server::windows_history() const {
 	return _windows_history;
 }
 
+LoopMonitor * Server::loop_monitor() const {
+	return _loop_monitor;
+}
+
 struct wlr_xdg_shell * Server::xdg_shell() const {
 	return _xdg_shell;
 }
 
+struct wlr_tearing_control_manager_v1 * Server::tearing_control_manager() const {
+	return _tearing_control_manager;
+}
+
+struct wlr_presentation * Server::presentation() const {
+	return _presentation;
+}
+
+struct wlr_linux_drm_syncobj_manager_v1 * Server::drm_syncobj_manager() const {
+	return _drm_syncobj_manager;
+}
+
 Server & Server::set_data(void * data) {
 	_data = data;
 	return *this;
 }
 
-Server & Server::on_destroy(const Handler & handler) {
+Server & Server::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_start(const Handler & handler) {
+Server & Server::on_start(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_start.push_back(std::move(handler));
+		_on_start.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_stop(const Handler & handler) {
+Server & Server::on_stop(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_stop.push_back(std::move(handler));
+		_on_stop.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_output_layout_change(const OutputLayoutChangeHandler & handler) {
+Server & Server::on_output_layout_change(const OutputLayoutChangeHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_output_layout_change.push_back(std::move(handler));
+		_on_output_layout_change.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_new_output(const NewOutputHandler & handler) {
+Server & Server::on_new_output(const NewOutputHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_output.push_back(std::move(handler));
+		_on_new_output.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_new_input(const NewInputHandler & handler) {
+Server & Server::on_new_input(const NewInputHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_input.push_back(std::move(handler));
+		_on_new_input.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_new_xdg_shell_toplevel(const NewSurfaceHandler & handler) {
+Server & Server::on_new_xdg_shell_toplevel(const NewSurfaceHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_xdg_shell_toplevel.push_back(std::move(handler));
+		_on_new_xdg_shell_toplevel.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Server & Server::on_new_xdg_shell_popup(const NewSurfaceHandler & handler) {
+Server & Server::on_new_xdg_shell_popup(const NewSurfaceHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_xdg_shell_popup.push_back(std::move(handler));
+		_on_new_xdg_shell_popup.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -404,9 +469,7 @@ void Server::_handle_output_layout_change(struct wl_listener * listener, void *
 		output->set_y(box.y);
 	}
 
-	for (auto & cb : server->_on_output_layout_change) {
-		cb(server, layout);
-	}
+	server->_on_output_layout_change.emit(server, layout);
 }
 
 void Server::_handle_new_output(struct wl_listener * listener, void * data) {
@@ -414,11 +477,9 @@ void Server::_handle_new_output(struct wl_listener * listener, void * data) {
 	auto wlr_output = static_cast<struct wlr_output*>(data);
 
 	auto output = new Output(server, wlr_output, nullptr);
-	server->_outputs.push_back(output);
+	server->_outputs.insert(output);
 
-	for (auto & cb : server->_on_new_output) {
-		cb(output, wlr_output, server);
-	}
+	server->_on_new_output.emit(output, wlr_output, server);
 }
 
 void Server::_handle_new_input(struct wl_listener * listener, void * data) {
@@ -450,26 +511,23 @@ void Server::_handle_new_input(struct wl_listener * listener, void * data) {
 		return;
 	}
 
-	server->_inputs.push_back(input);
+	server->_inputs.insert(input);
 
-	for (auto & cb : server->_on_new_input) {
-		cb(input, device, server);
-	}
+	server->_on_new_input.emit(input, device, server);
 }
 
 void Server::_handle_new_xdg_shell_toplevel(struct wl_listener * listener, void * data) {
 	Server * server = wl_container_of(listener, server, _new_xdg_shell_toplevel_listener);
 	auto xdg_toplevel = static_cast<struct wlr_xdg_toplevel*>(data);
+	// with no output left the window waits in staging until it is given a workspace
 	auto output = server->preferred_output();
-	auto workspace = output->current_workspace();
+	auto workspace = output ? output->current_workspace() : nullptr;
 
 	auto surface = new XDGToplevel(xdg_toplevel->base);
 	surface->ping();
 
 	auto window = new Window(server, workspace, surface);
-	for (auto & cb : server->_on_new_xdg_shell_toplevel) {
-		cb(window, surface, output);
-	}
+	server->_on_new_xdg_shell_toplevel.emit(window, surface, output);
 
 	// if (server->portal_manager) {
 	// 	window->foreign_toplevel = wlr_foreign_toplevel_handle_v1_create(
@@ -481,7 +539,7 @@ void Server::_handle_new_xdg_shell_popup(struct wl_listener * listener, void * d
 	Server * server = wl_container_of(listener, server, _new_xdg_shell_popup_listener);
 	auto xdg_popup = static_cast<struct wlr_xdg_popup*>(data);
 	auto output = server->preferred_output();
-	auto workspace = output->current_workspace();
+	auto workspace = output ? output->current_workspace() : nullptr;
 
 	// auto surface = new XDGPopup(xdg_popup->base);
 	// surface->ping();
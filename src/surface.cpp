@@ -32,9 +32,7 @@ Surface::Surface(struct wl_resource * resource, const Handler & callback) {
 }
 
 Surface::~Surface() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 }
 
 bool Surface::is_xdg_toplevel() const {
@@ -202,44 +200,44 @@ struct wlr_surface * Surface::wlr_surface() const {
 	return _surface;
 }
 
-Surface & Surface::on_destroy(const Handler & handler) {
+Surface & Surface::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(handler);
+		_on_destroy.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Surface & Surface::on_client_commit(const Handler & handler) {
+Surface & Surface::on_client_commit(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_client_commit.push_back(handler);
+		_on_client_commit.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Surface & Surface::on_commit(const Handler & handler) {
+Surface & Surface::on_commit(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_commit.push_back(handler);
+		_on_commit.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Surface & Surface::on_map(const Handler & handler) {
+Surface & Surface::on_map(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_map.push_back(handler);
+		_on_map.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Surface & Surface::on_unmap(const Handler & handler) {
+Surface & Surface::on_unmap(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_unmap.push_back(handler);
+		_on_unmap.push_back(handler, name, subscription);
 	}
 	return *this;
 }
 
-Surface & Surface::on_new_subsurface(const NewSubsurfaceHandler & handler) {
+Surface & Surface::on_new_subsurface(const NewSubsurfaceHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_subsurface.push_back(handler);
+		_on_new_subsurface.push_back(handler, name, subscription);
 	}
 	return *this;
 }
@@ -247,46 +245,34 @@ Surface & Surface::on_new_subsurface(const NewSubsurfaceHandler & handler) {
 void Surface::_handle_destroy(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _destroy_listener);
 
-	for (auto & cb : surface->_on_destroy) {
-		cb(surface);
-	}
+	surface->_on_destroy.emit(surface);
 
 	delete surface;
 }
 
 void Surface::_handle_client_commit(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _client_commit_listener);
-	for (auto & cb : surface->_on_client_commit) {
-		cb(surface);
-	}
+	surface->_on_client_commit.emit(surface);
 }
 
 void Surface::_handle_commit(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _commit_listener);
-	for (auto & cb : surface->_on_commit) {
-		cb(surface);
-	}
+	surface->_on_commit.emit(surface);
 }
 
 void Surface::_handle_map(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _map_listener);
-	for (auto & cb : surface->_on_map) {
-		cb(surface);
-	}
+	surface->_on_map.emit(surface);
 }
 
 void Surface::_handle_unmap(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _unmap_listener);
-	for (auto & cb : surface->_on_unmap) {
-		cb(surface);
-	}
+	surface->_on_unmap.emit(surface);
 }
 
 void Surface::_handle_new_subsurface(struct ::wl_listener * listener, void * data) {
 	Surface * surface = wl_container_of(listener, surface, _new_subsurface_listener);
 	auto * subsurface = static_cast<struct wlr_subsurface*>(data);
 
-	for (auto & cb : surface->_on_new_subsurface) {
-		cb(surface, subsurface);
-	}
+	surface->_on_new_subsurface.emit(surface, subsurface);
 }
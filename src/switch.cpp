@@ -23,23 +23,23 @@ Switch * Switch::as_switch() {
 	return this;
 }
 
-Switch & Switch::on_toggle(const ToggleHandler & handler) {
+Switch & Switch::on_toggle(const ToggleHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_toggle.push_back(std::move(handler));
+		_on_toggle.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Switch & Switch::on_toggle_on(const ToggleStateHandler & handler) {
+Switch & Switch::on_toggle_on(const ToggleStateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_toggle_on.push_back(std::move(handler));
+		_on_toggle_on.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Switch & Switch::on_toggle_off(const ToggleStateHandler & handler) {
+Switch & Switch::on_toggle_off(const ToggleStateHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_toggle_off.push_back(std::move(handler));
+		_on_toggle_off.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -60,13 +60,9 @@ void Switch::_handle_toggle(struct wl_listener * listener, void * data) {
 		return;
 	}
 
- 	for (auto & cb : switch_->_on_toggle) {
-		cb(switch_, type, event->switch_state);
-	}
+	switch_->_on_toggle.emit(switch_, type, event->switch_state);
 
-	auto handlers = event->switch_state == WLR_SWITCH_STATE_ON
+	auto & handlers = event->switch_state == WLR_SWITCH_STATE_ON
 		? switch_->_on_toggle_on : switch_->_on_toggle_off;
-	for (auto & cb : handlers) {
-		cb(switch_, type);
-	}
+	handlers.emit(switch_, type);
 }
@@ -0,0 +1,202 @@
+#include <algorithm>
+
+extern "C" {
+#include <drm_fourcc.h>
+#include <wlr/render/allocator.h>
+#include <wlr/render/drm_format_set.h>
+#include <wlr/render/pixman.h>
+#include <wlr/types/wlr_scene.h>
+}
+
+#include "window.hpp"
+#include "server.hpp"
+#include "output.hpp"
+#include "render.hpp"
+
+using namespace wlkit;
+
+Thumbnail::Thumbnail(Window * window, Geo max_width, Geo max_height):
+_window(window), _output(nullptr), _buffer(nullptr), _texture(nullptr),
+_max_width(max_width), _max_height(max_height), _width(0), _height(0), _box{}, _dirty(true) {
+	if (!_window) {
+		// TODO error
+	}
+}
+
+Thumbnail::~Thumbnail() {
+	_release();
+}
+
+Thumbnail & Thumbnail::mark_dirty() {
+	_dirty = true;
+	if (!_output) {
+		return *this;
+	}
+
+	// only the cell showing the thumbnail has to be drawn again
+	if (wlr_box_empty(&_box)) {
+		_output->request_redraw();
+	} else {
+		_output->damage_buffer_box(&_box);
+	}
+	return *this;
+}
+
+Thumbnail & Thumbnail::set_max_size(Geo max_width, Geo max_height) {
+	if (max_width != _max_width || max_height != _max_height) {
+		_max_width = max_width;
+		_max_height = max_height;
+		_dirty = true;
+	}
+	return *this;
+}
+
+// the box is where the thumbnail is drawn, in buffer coordinates of the output
+Thumbnail & Thumbnail::show_on(Output * output, const struct wlr_box * box) {
+	_output = output;
+	_box = output && box ? *box : wlr_box{};
+	return *this;
+}
+
+bool Thumbnail::update() {
+	if (!_dirty) {
+		return false;
+	}
+
+	auto tree = _window->scene_tree();
+	auto renderer = _window->server()->renderer();
+	if (!tree || !renderer || _window->width() <= 0 || _window->height() <= 0) {
+		return false;
+	}
+
+	float scale = static_cast<float>(std::min({
+		_max_width / _window->width(), _max_height / _window->height(), 1.0 }));
+	int width = std::max(1, static_cast<int>(_window->width() * scale));
+	int height = std::max(1, static_cast<int>(_window->height() * scale));
+	if ((width != _width || height != _height || !_buffer) && !_allocate(width, height)) {
+		return false;
+	}
+
+	auto pass = wlr_renderer_begin_buffer_pass(renderer, _buffer, nullptr);
+	if (!pass) {
+		return false;
+	}
+
+	struct wlr_render_rect_options clear{};
+	clear.box = { 0, 0, _width, _height };
+	clear.color = { 0.0f, 0.0f, 0.0f, 0.0f };
+	clear.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+	wlr_render_pass_add_rect(pass, &clear);
+
+	struct Context {
+		struct wlr_render_pass * pass;
+		int x, y;
+		float scale;
+	} context{ pass, 0, 0, scale };
+	wlr_scene_node_coords(&tree->node, &context.x, &context.y);
+
+	// draws what the scene graph shows for the window, popups and subsurfaces included
+	wlr_scene_node_for_each_buffer(&tree->node, [](struct wlr_scene_buffer * scene_buffer, int sx, int sy, void * data) {
+		auto context = static_cast<Context*>(data);
+		auto scene_surface = wlr_scene_surface_try_from_buffer(scene_buffer);
+		auto texture = scene_surface ? wlr_surface_get_texture(scene_surface->surface) : nullptr;
+		if (!texture) {
+			return;
+		}
+
+		int width = scene_buffer->dst_width > 0 ? scene_buffer->dst_width : scene_surface->surface->current.width;
+		int height = scene_buffer->dst_height > 0 ? scene_buffer->dst_height : scene_surface->surface->current.height;
+
+		struct wlr_render_texture_options opts{};
+		opts.texture = texture;
+		opts.src_box = scene_buffer->src_box;
+		opts.dst_box = {
+			static_cast<int>((sx - context->x) * context->scale),
+			static_cast<int>((sy - context->y) * context->scale),
+			std::max(1, static_cast<int>(width * context->scale)),
+			std::max(1, static_cast<int>(height * context->scale)),
+		};
+		opts.transform = scene_buffer->transform;
+		opts.filter_mode = WLR_SCALE_FILTER_BILINEAR;
+		Render::wait_for_surface(scene_surface->surface, &opts);
+		wlr_render_pass_add_texture(context->pass, &opts);
+	}, &context);
+
+	if (!wlr_render_pass_submit(pass)) {
+		return false;
+	}
+
+	// gpu textures sample the buffer itself, pixman ones keep a copy and are imported after every redraw
+	if (_texture && wlr_renderer_is_pixman(renderer)) {
+		wlr_texture_destroy(_texture);
+		_texture = nullptr;
+	}
+	if (!_texture) {
+		_texture = wlr_texture_from_buffer(renderer, _buffer);
+	}
+
+	_dirty = false;
+	return true;
+}
+
+Window * Thumbnail::window() const {
+	return _window;
+}
+
+Output * Thumbnail::output() const {
+	return _output;
+}
+
+const struct wlr_box * Thumbnail::box() const {
+	return &_box;
+}
+
+struct wlr_texture * Thumbnail::texture() const {
+	return _texture;
+}
+
+int Thumbnail::width() const {
+	return _width;
+}
+
+int Thumbnail::height() const {
+	return _height;
+}
+
+bool Thumbnail::dirty() const {
+	return _dirty;
+}
+
+bool Thumbnail::_allocate(int width, int height) {
+	_release();
+
+	auto server = _window->server();
+	auto formats = wlr_renderer_get_render_formats(server->renderer());
+	auto format = formats ? wlr_drm_format_set_get(formats, DRM_FORMAT_ARGB8888) : nullptr;
+	if (!format) {
+		// TODO error
+		return false;
+	}
+
+	_buffer = wlr_allocator_create_buffer(server->allocator(), width, height, format);
+	if (!_buffer) {
+		// TODO error
+		return false;
+	}
+
+	_width = width;
+	_height = height;
+	return true;
+}
+
+void Thumbnail::_release() {
+	if (_texture) {
+		wlr_texture_destroy(_texture);
+		_texture = nullptr;
+	}
+	if (_buffer) {
+		wlr_buffer_drop(_buffer);
+		_buffer = nullptr;
+	}
+	_width = _height = 0;
+}
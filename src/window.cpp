@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include "window.hpp"
 #include "workspace.hpp"
 #include "server.hpp"
@@ -12,10 +15,11 @@ using namespace wlkit;
 
 Window::Window(Server * server, Workspace * workspace, Surface * surface,
 	const char * title, const char * app_id, const Handler & callback):
-_server(server), _workspace(workspace), _surface(surface),
+_server(server), _workspace(workspace), _surface(surface), _scene_tree(nullptr),
 _x(0.0), _y(0.0), _width(1.0), _height(1.0),
 _mapped(false), _minimized(false), _maximized(false), _fullscreened(false),
-_ready(false), _dirty(true), _resizing(false), _closed(false), _data(nullptr) {
+_ready(false), _dirty(true), _resizing(false), _closed(false),
+_tearing_policy(TearingPolicy::CLIENT), _thumbnail(nullptr), _data(nullptr) {
 	_x = _y = 0.0;
 	if (workspace && workspace->output()) {
 		auto output = workspace->output();
@@ -66,20 +70,29 @@ _ready(false), _dirty(true), _resizing(false), _closed(false), _data(nullptr) {
 }
 
 Window::~Window() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
-	}
+	_on_destroy.emit(this);
 
 	if (!_closed) {
 		close();
 	}
 
+	while (!_popups.empty()) {
+		_untrack_popup(&_popups.front());
+	}
+
+	delete _thumbnail;
+	if (_scene_tree) {
+		wlr_scene_node_destroy(&_scene_tree->node);
+	}
+
 	delete _workspaces_history;
 	free(_app_id);
 	free(_title);
 }
 
 Window & Window::close() {
+	damage();
+
 	if (_workspace) {
 		_workspace->remove_window(this);
 	}
@@ -94,22 +107,24 @@ Window & Window::close() {
 		_surface->close();
 	}
 
-	for (auto & cb : _on_close) {
-		cb(this);
-	}
+	_on_close.emit(this);
 
 	_closed = true;
 	return *this;
 }
 
 Window & Window::move(Geo x, Geo y) {
+	damage();
 	_x = x;
 	_y = y;
 	_dirty = true;
-
-	for (auto & cb : _on_move) {
-		cb(this);
+	if (_scene_tree) {
+		wlr_scene_node_set_position(&_scene_tree->node, static_cast<int>(_x), static_cast<int>(_y));
 	}
+	damage();
+	_update_grid();
+
+	_on_move.emit(this);
 
 	return *this;
 }
@@ -122,14 +137,18 @@ Window & Window::resize(Geo width, Geo height) {
 	if (_surface) {
 		_surface->set_size(width, height);
 	} else {
+		damage();
 		_width = width;
 		_height = height;
 		_dirty = true;
+		damage();
+		if (_thumbnail) {
+			_thumbnail->mark_dirty();
+		}
+		_update_grid();
 	}
 
-	for (auto & cb : _on_resize) {
-		cb(this);
-	}
+	_on_resize.emit(this);
 
 	return *this;
 }
@@ -139,6 +158,10 @@ Window & Window::resize(Geo width, Geo height) {
  */
 Window & Window::map() {
 	_mapped = true;
+	if (_scene_tree) {
+		wlr_scene_node_set_enabled(&_scene_tree->node, true);
+	}
+	_update_grid();
 	return *this;
 }
 
@@ -147,6 +170,10 @@ Window & Window::map() {
  */
 Window & Window::unmap() {
 	_mapped = false;
+	if (_scene_tree) {
+		wlr_scene_node_set_enabled(&_scene_tree->node, false);
+	}
+	_update_grid();
 	return *this;
 }
 
@@ -191,6 +218,8 @@ Window & Window::minimize() {
 
 	_minimized = true;
 	_dirty = true;
+	damage();
+	_update_grid();
 
 	// if (_foreign_toplevel) {
 		// wlr_foreign_toplevel_handle_v1_set_minimized(_foreign_toplevel, _minimized);
@@ -206,6 +235,8 @@ Window & Window::unminimize() {
 
 	_minimized = false;
 	_dirty = true;
+	damage();
+	_update_grid();
 
 	return *this;
 }
@@ -216,7 +247,7 @@ Window & Window::fullscreen() {
 	}
 
 	if (_surface) {
-		_surface->set_fullscreen(_fullscreened);
+		_surface->set_fullscreen(true);
 	} else {
 		_fullscreened = true;
 		_dirty = true;
@@ -235,7 +266,7 @@ Window & Window::unfullscreen() {
 	}
 
 	if (_surface) {
-		_surface->set_fullscreen(_fullscreened);
+		_surface->set_fullscreen(false);
 	} else {
 		_fullscreened = false;
 		_dirty = true;
@@ -244,6 +275,104 @@ Window & Window::unfullscreen() {
 	return *this;
 }
 
+Window & Window::damage() {
+	auto output = this->output();
+	if (!output) {
+		return *this;
+	}
+
+	// the scene graph damages its own nodes
+	if (_scene_tree && output->render_mode() == Output::RenderMode::SCENE) {
+		return *this;
+	}
+
+	struct wlr_box box = {
+		.x = static_cast<int>(_x),
+		.y = static_cast<int>(_y),
+		.width = static_cast<int>(_width),
+		.height = static_cast<int>(_height),
+	};
+	output->damage_box(&box);
+	return *this;
+}
+
+Window & Window::send_frame_done(const struct timespec * when) {
+	if (!_surface) {
+		return *this;
+	}
+
+	auto send = [](struct wlr_surface * surface, int sx, int sy, void * data) {
+		wlr_surface_send_frame_done(surface, static_cast<const struct timespec*>(data));
+	};
+
+	if (_surface->is_xdg_toplevel()) {
+		wlr_xdg_surface_for_each_surface(_surface->as_xdg_toplevel()->xdg_surface(),
+			send, const_cast<struct timespec*>(when));
+	} else {
+		wlr_surface_for_each_surface(_surface->wlr_surface(),
+			send, const_cast<struct timespec*>(when));
+	}
+
+	return *this;
+}
+
+struct wlr_buffer * Window::scanout_buffer() const {
+	if (!_surface || !_mapped || _minimized || !_fullscreened || _x != 0 || _y != 0) {
+		return nullptr;
+	}
+
+	auto wlr_surface = _surface->wlr_surface();
+	if (!wlr_surface || !wlr_surface->buffer) {
+		return nullptr;
+	}
+
+	// the buffer alone must be the whole picture: no subsurfaces, popups or holes
+	if (!wl_list_empty(&wlr_surface->current.subsurfaces_below) ||
+		!wl_list_empty(&wlr_surface->current.subsurfaces_above)
+	) {
+		return nullptr;
+	}
+	if (_surface->is_xdg_toplevel() && !wl_list_empty(&_surface->as_xdg_toplevel()->xdg_surface()->popups)) {
+		return nullptr;
+	}
+	pixman_box32_t extents = {0, 0, wlr_surface->current.width, wlr_surface->current.height};
+	if (pixman_region32_contains_rectangle(&wlr_surface->opaque_region, &extents) != PIXMAN_REGION_IN) {
+		return nullptr;
+	}
+
+	return &wlr_surface->buffer->base;
+}
+
+Window & Window::sample(Output * output, bool scanned_out) {
+	if (!_surface || !_mapped || _minimized || !output) {
+		return *this;
+	}
+
+	struct Context {
+		Output * output;
+		bool scanned_out;
+	} context{ output, scanned_out };
+
+	// the feedback itself is sent by wlr_presentation on the output's present event
+	auto sample = [](struct wlr_surface * surface, int sx, int sy, void * data) {
+		auto context = static_cast<Context*>(data);
+		auto render = context->output->render();
+		if (context->scanned_out || render->is_offloaded(surface)) {
+			wlr_presentation_surface_scanned_out_on_output(surface, context->output->wlr_output());
+		} else {
+			wlr_presentation_surface_textured_on_output(surface, context->output->wlr_output());
+		}
+	};
+
+	if (_surface->is_xdg_toplevel()) {
+		wlr_xdg_surface_for_each_surface(_surface->as_xdg_toplevel()->xdg_surface(), sample, &context);
+	} else {
+		wlr_surface_for_each_surface(_surface->wlr_surface(), sample, &context);
+	}
+
+	return *this;
+}
+
 Server * Window::server() const {
 	return _server;
 }
@@ -252,10 +381,26 @@ Workspace * Window::workspace() const {
 	return _workspace;
 }
 
+Output * Window::output() const {
+	if (!_workspace) {
+		return nullptr;
+	}
+
+	auto output = _workspace->output();
+	if (!output || output->current_workspace() != _workspace) {
+		return nullptr;
+	}
+	return output;
+}
+
 Surface * Window::surface() const {
 	return _surface;
 }
 
+struct wlr_scene_tree * Window::scene_tree() const {
+	return _scene_tree;
+}
+
 const char * Window::title() const {
 	return _title;
 }
@@ -280,6 +425,70 @@ Geo Window::height() const {
 	return _height;
 }
 
+struct wlr_box Window::bounds() const {
+	struct wlr_box box = {
+		.x = static_cast<int>(std::floor(_x)),
+		.y = static_cast<int>(std::floor(_y)),
+		.width = static_cast<int>(std::ceil(_width)),
+		.height = static_cast<int>(std::ceil(_height)),
+	};
+	if (!_surface) {
+		return box;
+	}
+
+	auto extend = [](struct wlr_box * box, const struct wlr_box & other) {
+		if (wlr_box_empty(&other)) {
+			return;
+		}
+		int x2 = std::max(box->x + box->width, other.x + other.width);
+		int y2 = std::max(box->y + box->height, other.y + other.height);
+		box->x = std::min(box->x, other.x);
+		box->y = std::min(box->y, other.y);
+		box->width = x2 - box->x;
+		box->height = y2 - box->y;
+	};
+
+	struct Context {
+		struct wlr_box * box;
+		int x, y;
+		decltype(extend) * extend;
+	} context{ &box, box.x, box.y, &extend };
+
+	// subsurfaces and popups may stick out of the window geometry
+	if (_surface->is_xdg_toplevel()) {
+		auto xdg_surface = _surface->as_xdg_toplevel()->xdg_surface();
+		context.x -= xdg_surface->geometry.x;
+		context.y -= xdg_surface->geometry.y;
+		wlr_xdg_surface_for_each_surface(xdg_surface, [](struct wlr_surface * surface, int sx, int sy, void * data) {
+			auto context = static_cast<Context*>(data);
+			(*context->extend)(context->box, {
+				context->x + sx, context->y + sy, surface->current.width, surface->current.height });
+		}, &context);
+	} else {
+		struct wlr_box extents;
+		wlr_surface_get_extents(_surface->wlr_surface(), &extents);
+		extents.x += context.x;
+		extents.y += context.y;
+		extend(&box, extents);
+	}
+
+	return box;
+}
+
+struct wlr_surface * Window::surface_at(Geo x, Geo y, Geo * sx, Geo * sy) const {
+	if (!_surface) {
+		return nullptr;
+	}
+
+	if (_surface->is_xdg_toplevel()) {
+		auto xdg_surface = _surface->as_xdg_toplevel()->xdg_surface();
+		return wlr_xdg_surface_surface_at(xdg_surface,
+			x - std::floor(_x) + xdg_surface->geometry.x,
+			y - std::floor(_y) + xdg_surface->geometry.y, sx, sy);
+	}
+	return wlr_surface_surface_at(_surface->wlr_surface(), x - std::floor(_x), y - std::floor(_y), sx, sy);
+}
+
 bool Window::mapped() const {
 	return _mapped;
 }
@@ -308,6 +517,32 @@ WorkspacesHistory * Window::workspaces_history() const {
 	return _workspaces_history;
 }
 
+Window::TearingPolicy Window::tearing_policy() const {
+	return _tearing_policy;
+}
+
+bool Window::allows_tearing() const {
+	switch (_tearing_policy) {
+	case TearingPolicy::ALLOW:
+		return true;
+	case TearingPolicy::DENY:
+		return false;
+	case TearingPolicy::CLIENT:
+		break;
+	}
+
+	auto manager = _server->tearing_control_manager();
+	if (!manager || !_surface || !_surface->wlr_surface()) {
+		return false;
+	}
+	return wlr_tearing_control_manager_v1_surface_hint_from_surface(manager, _surface->wlr_surface())
+		== WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC;
+}
+
+Thumbnail * Window::thumbnail() const {
+	return _thumbnail;
+}
+
 void * Window::data() const {
 	return _data;
 }
@@ -318,13 +553,28 @@ Window & Window::drawn() {
 }
 
 Window & Window::set_workspace(Workspace * workspace) {
+	damage();
 	if (_workspace) {
 		_workspace->remove_window(this);
 	}
 
+	auto previous = _workspace;
 	_workspace = workspace;
+	if (!workspace) {
+		// detached windows wait in staging, their tree must not die with the old workspace
+		_workspaces_history->remove(previous);
+		if (_scene_tree) {
+			wlr_scene_node_reparent(&_scene_tree->node, _server->root()->staging());
+		}
+		return *this;
+	}
+
 	_workspaces_history->shift(_workspace);
 	workspace->add_window(this);
+	if (_scene_tree && workspace->scene_tree()) {
+		wlr_scene_node_reparent(&_scene_tree->node, workspace->scene_tree());
+	}
+	damage();
 
 	return *this;
 }
@@ -333,9 +583,7 @@ Window & Window::set_title(const char * title) {
 	free(_title);
 	_title = strdup(title ? title : "");
 
-	for (auto & cb : _on_set_title) {
-		cb(this);
-	}
+	_on_set_title.emit(this);
 
 	return *this;
 }
@@ -344,9 +592,7 @@ Window & Window::set_app_id(const char * app_id) {
 	free(_app_id);
 	_app_id = strdup(app_id ? app_id : "");
 
-	for (auto & cb : _on_set_app_id) {
-		cb(this);
-	}
+	_on_set_app_id.emit(this);
 
 	return *this;
 }
@@ -356,93 +602,113 @@ Window & Window::set_data(void * data) {
 	return *this;
 }
 
-Window & Window::on_destroy(const Handler & handler) {
+Window & Window::set_tearing_policy(TearingPolicy policy) {
+	_tearing_policy = policy;
+	return *this;
+}
+
+Window & Window::enable_thumbnail(Geo max_width, Geo max_height) {
+	if (_thumbnail) {
+		_thumbnail->set_max_size(max_width, max_height);
+	} else {
+		_thumbnail = new Thumbnail(this, max_width, max_height);
+	}
+	return *this;
+}
+
+Window & Window::disable_thumbnail() {
+	delete _thumbnail;
+	_thumbnail = nullptr;
+	return *this;
+}
+
+Window & Window::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_close(const Handler & handler) {
+Window & Window::on_close(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_close.push_back(std::move(handler));
+		_on_close.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_set_title(const Handler & handler) {
+Window & Window::on_set_title(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_set_title.push_back(std::move(handler));
+		_on_set_title.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_set_app_id(const Handler & handler) {
+Window & Window::on_set_app_id(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_set_app_id.push_back(std::move(handler));
+		_on_set_app_id.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_move(const Handler & handler) {
+Window & Window::on_move(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_move.push_back(std::move(handler));
+		_on_move.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_resize(const Handler & handler) {
+Window & Window::on_resize(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_resize.push_back(std::move(handler));
+		_on_resize.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_map(const Handler & handler) {
+Window & Window::on_map(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_map.push_back(std::move(handler));
+		_on_map.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_unmap(const Handler & handler) {
+Window & Window::on_unmap(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_unmap.push_back(std::move(handler));
+		_on_unmap.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_configure(const Handler & handler) {
+Window & Window::on_configure(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_configure.push_back(std::move(handler));
+		_on_configure.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_ack_configure(const Handler & handler) {
+Window & Window::on_ack_configure(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_ack_configure.push_back(std::move(handler));
+		_on_ack_configure.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_commit(const Handler & handler) {
+Window & Window::on_commit(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_commit.push_back(std::move(handler));
+		_on_commit.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_ping_timeout(const Handler & handler) {
+Window & Window::on_ping_timeout(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_ping_timeout.push_back(std::move(handler));
+		_on_ping_timeout.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
 
-Window & Window::on_new_subsurface(const NewSubsurfaceHandler & handler) {
+Window & Window::on_new_subsurface(const NewSubsurfaceHandler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_new_subsurface.push_back(std::move(handler));
+		_on_new_subsurface.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
@@ -456,10 +722,16 @@ void Window::_setup_xdg_toplevel() {
 	auto xdg_surface = surface->xdg_surface();
 	auto toplevel = surface->toplevel();
 
+	auto parent = _workspace && _workspace->scene_tree()
+		? _workspace->scene_tree() : _server->root()->staging();
+
 	bool failed = false;
-	auto scene = Node::alloc_scene_tree(_server->root()->staging(), &failed);
+	_scene_tree = Node::alloc_scene_tree(parent, &failed);
 	if (!failed) {
-		wlr_scene_xdg_surface_create(scene, xdg_surface);
+		_scene_tree->node.data = this;
+		wlr_scene_node_set_enabled(&_scene_tree->node, false);
+		wlr_scene_node_set_position(&_scene_tree->node, static_cast<int>(_x), static_cast<int>(_y));
+		wlr_scene_xdg_surface_create(_scene_tree, xdg_surface);
 	}
 	// xdg_shell_view->image_capture_tree =
 	// 	wlr_scene_xdg_surface_create(&xdg_shell_view->view.image_capture_scene->tree, xdg_toplevel->base);
@@ -493,6 +765,8 @@ void Window::_setup_xdg_toplevel() {
 	wl_signal_add(&xdg_surface->events.ping_timeout, &_ping_timeout_listener);
 	_new_subsurface_listener.notify = _handle_new_subsurface;
 	wl_signal_add(&wlr_surface->events.new_subsurface, &_new_subsurface_listener);
+	_new_popup_listener.notify = _handle_new_popup;
+	wl_signal_add(&xdg_surface->events.new_popup, &_new_popup_listener);
 
 	_ready = false;
 }
@@ -514,6 +788,33 @@ void Window::_configure_xdg_toplevel() {
 	_ready = true;
 }
 
+void Window::_update_grid() {
+	if (_workspace) {
+		_workspace->grid()->update(this);
+	}
+}
+
+void Window::_track_popup(struct wlr_xdg_popup * popup) {
+	_popups.emplace_back();
+	auto & tracked = _popups.back();
+	tracked.window = this;
+	tracked.commit_listener.notify = _handle_popup_commit;
+	wl_signal_add(&popup->base->surface->events.commit, &tracked.commit_listener);
+	tracked.destroy_listener.notify = _handle_popup_destroy;
+	wl_signal_add(&popup->events.destroy, &tracked.destroy_listener);
+	tracked.new_popup_listener.notify = _handle_popup_new_popup;
+	wl_signal_add(&popup->base->events.new_popup, &tracked.new_popup_listener);
+}
+
+void Window::_untrack_popup(Popup * popup) {
+	wl_list_remove(&popup->commit_listener.link);
+	wl_list_remove(&popup->destroy_listener.link);
+	wl_list_remove(&popup->new_popup_listener.link);
+	_popups.remove_if([popup](const Popup & p) {
+		return &p == popup;
+	});
+}
+
 void Window::_handle_destroy(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _destroy_listener);
 	delete window;
@@ -532,19 +833,29 @@ void Window::_handle_set_app_id(struct wl_listener * listener, void * data) {
 void Window::_handle_map(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _map_listener);
 	window->_mapped = true;
-
-	for (auto & cb : window->_on_map) {
-		cb(window);
+	if (window->_scene_tree) {
+		wlr_scene_node_set_enabled(&window->_scene_tree->node, true);
+		wlr_scene_node_raise_to_top(&window->_scene_tree->node);
+	}
+	window->damage();
+	window->_update_grid();
+	if (window->_workspace) {
+		window->_workspace->grid()->raise(window);
 	}
+
+	window->_on_map.emit(window);
 }
 
 void Window::_handle_unmap(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _unmap_listener);
 	window->_mapped = false;
-
-	for (auto & cb : window->_on_unmap) {
-		cb(window);
+	if (window->_scene_tree) {
+		wlr_scene_node_set_enabled(&window->_scene_tree->node, false);
 	}
+	window->damage();
+	window->_update_grid();
+
+	window->_on_unmap.emit(window);
 }
 
 void Window::_handle_configure(struct wl_listener * listener, void * data) {
@@ -553,6 +864,7 @@ void Window::_handle_configure(struct wl_listener * listener, void * data) {
 	auto surface = window->_surface;
 
 	if (surface->is_xdg_toplevel()) {
+		window->damage();
 		if (event->toplevel_configure->width >= 1 && event->toplevel_configure->height >= 1) {
 			window->_width = event->toplevel_configure->width;
 			window->_height = event->toplevel_configure->height;
@@ -566,18 +878,16 @@ void Window::_handle_configure(struct wl_listener * listener, void * data) {
 	// TODO xwayland
 
 	window->_dirty = true;
+	window->damage();
+	window->_update_grid();
 
-	for (auto & cb : window->_on_configure) {
-		cb(window);
-	}
+	window->_on_configure.emit(window);
 }
 
 void Window::_handle_ack_configure(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _ack_configure_listener);
 
-	for (auto & cb : window->_on_ack_configure) {
-		cb(window);
-	}
+	window->_on_ack_configure.emit(window);
 }
 
 void Window::_handle_commit(struct wl_listener * listener, void * data) {
@@ -590,25 +900,53 @@ void Window::_handle_commit(struct wl_listener * listener, void * data) {
 		// TODO xwayland
 	}
 	// window->_dirty = true;
-
-	for (auto & cb : window->_on_commit) {
-		cb(window);
+	auto wlr_surface = window->_surface->wlr_surface();
+	if (wlr_surface->current.committed & WLR_SURFACE_STATE_BUFFER) {
+		window->damage();
+		if (window->_thumbnail) {
+			window->_thumbnail->mark_dirty();
+		}
+		window->_update_grid();
+	} else if (auto output = window->output()) {
+		// no new content, but the client still waits for its frame callback.
+		// a frame event sends it, there is nothing to render
+		wlr_output_schedule_frame(output->wlr_output());
 	}
+
+	window->_on_commit.emit(window);
 }
 
 void Window::_handle_ping_timeout(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _ping_timeout_listener);
 
-	for (auto & cb : window->_on_ping_timeout) {
-		cb(window);
-	}
+	window->_on_ping_timeout.emit(window);
 }
 
 void Window::_handle_new_subsurface(struct wl_listener * listener, void * data) {
 	Window * window = wl_container_of(listener, window, _new_subsurface_listener);
 	auto subsurface = static_cast<struct wlr_subsurface*>(data);
 
-	for (auto & cb : window->_on_new_subsurface) {
-		cb(window, subsurface);
-	}
+	window->_on_new_subsurface.emit(window, subsurface);
+}
+
+void Window::_handle_new_popup(struct wl_listener * listener, void * data) {
+	Window * window = wl_container_of(listener, window, _new_popup_listener);
+	window->_track_popup(static_cast<struct wlr_xdg_popup*>(data));
+}
+
+void Window::_handle_popup_commit(struct wl_listener * listener, void * data) {
+	Popup * popup = wl_container_of(listener, popup, commit_listener);
+	popup->window->_update_grid();
+}
+
+void Window::_handle_popup_destroy(struct wl_listener * listener, void * data) {
+	Popup * popup = wl_container_of(listener, popup, destroy_listener);
+	auto window = popup->window;
+	window->_untrack_popup(popup);
+	window->_update_grid();
+}
+
+void Window::_handle_popup_new_popup(struct wl_listener * listener, void * data) {
+	Popup * popup = wl_container_of(listener, popup, new_popup_listener);
+	popup->window->_track_popup(static_cast<struct wlr_xdg_popup*>(data));
 }
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+
+#include "workspace.hpp"
+#include "window.hpp"
+
+using namespace wlkit;
+
+WindowGrid::WindowGrid():
+_next_z(0) {}
+
+WindowGrid::~WindowGrid() {}
+
+WindowGrid & WindowGrid::update(Window * window) {
+	if (!window->mapped() || window->minimized()) {
+		return remove(window);
+	}
+
+	struct wlr_box box = window->bounds();
+	auto it = _entries.find(window);
+	if (it == _entries.end()) {
+		_entries[window] = { box, ++_next_z };
+		_insert(window, box);
+		return *this;
+	}
+
+	if (wlr_box_equal(&it->second.box, &box)) {
+		return *this;
+	}
+
+	_erase(window, it->second.box);
+	it->second.box = box;
+	_insert(window, box);
+	return *this;
+}
+
+WindowGrid & WindowGrid::raise(Window * window) {
+	auto it = _entries.find(window);
+	if (it == _entries.end() || it->second.z == _next_z) {
+		return *this;
+	}
+
+	_erase(window, it->second.box);
+	it->second.z = ++_next_z;
+	_insert(window, it->second.box);
+	return *this;
+}
+
+WindowGrid & WindowGrid::remove(Window * window) {
+	auto it = _entries.find(window);
+	if (it == _entries.end()) {
+		return *this;
+	}
+
+	_erase(window, it->second.box);
+	_entries.erase(it);
+	return *this;
+}
+
+WindowGrid & WindowGrid::clear() {
+	_entries.clear();
+	_cells.clear();
+	return *this;
+}
+
+bool WindowGrid::hit_test(Geo x, Geo y, Hit * hit) const {
+	auto cell = _cells.find(_key(_cell(static_cast<int>(std::floor(x))), _cell(static_cast<int>(std::floor(y)))));
+	if (cell == _cells.end()) {
+		return false;
+	}
+
+	// cells are kept top to bottom, the first window that takes the point wins
+	for (auto window : cell->second) {
+		auto & box = _entries.at(window).box;
+		if (!wlr_box_contains_point(&box, x, y)) {
+			continue;
+		}
+
+		Geo sx = x - window->x(), sy = y - window->y();
+		struct wlr_surface * surface = nullptr;
+		if (window->surface()) {
+			// input regions and popups decide, a miss falls through to the window below
+			surface = window->surface_at(x, y, &sx, &sy);
+			if (!surface) {
+				continue;
+			}
+		} else if (sx < 0 || sy < 0 || sx >= window->width() || sy >= window->height()) {
+			continue;
+		}
+
+		if (hit) {
+			*hit = { window, surface, sx, sy };
+		}
+		return true;
+	}
+
+	return false;
+}
+
+Window * WindowGrid::window_at(Geo x, Geo y) const {
+	Hit hit;
+	return hit_test(x, y, &hit) ? hit.window : nullptr;
+}
+
+size_t WindowGrid::size() const {
+	return _entries.size();
+}
+
+void WindowGrid::_insert(Window * window, const struct wlr_box & box) {
+	uint64_t z = _entries.at(window).z;
+	_for_each_cell(box, [this, window, z](uint64_t key) {
+		auto & cell = _cells[key];
+		auto pos = std::find_if(cell.begin(), cell.end(), [this, z](Window * other) {
+			return _entries.at(other).z < z;
+		});
+		cell.insert(pos, window);
+	});
+}
+
+void WindowGrid::_erase(Window * window, const struct wlr_box & box) {
+	_for_each_cell(box, [this, window](uint64_t key) {
+		auto cell = _cells.find(key);
+		if (cell == _cells.end()) {
+			return;
+		}
+		std::erase(cell->second, window);
+		if (cell->second.empty()) {
+			_cells.erase(cell);
+		}
+	});
+}
+
+template <typename F>
+void WindowGrid::_for_each_cell(const struct wlr_box & box, F && f) {
+	if (wlr_box_empty(&box)) {
+		return;
+	}
+
+	int x1 = _cell(box.x), x2 = _cell(box.x + box.width - 1);
+	int y1 = _cell(box.y), y2 = _cell(box.y + box.height - 1);
+	for (int cy = y1; cy <= y2; ++cy) {
+		for (int cx = x1; cx <= x2; ++cx) {
+			f(_key(cx, cy));
+		}
+	}
+}
+
+uint64_t WindowGrid::_key(int cx, int cy) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+int WindowGrid::_cell(int coord) {
+	// rounds towards negative infinity, windows may hang off the left or top edge
+	return coord >= 0 ? coord / CELL_SIZE : (coord - CELL_SIZE + 1) / CELL_SIZE;
+}
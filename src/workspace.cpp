@@ -1,5 +1,8 @@
 #include "workspace.hpp"
 #include "server.hpp"
+#include "root.hpp"
+#include "node.hpp"
+#include "output.hpp"
 #include "window.hpp"
 
 #include <algorithm>
@@ -7,9 +10,18 @@
 using namespace wlkit;
 
 Workspace::Workspace(Server * server, Layout * layout, ID id, const char * name, const Handler & callback):
-_server(server), _layout(layout), _id(id), _focused_window(nullptr), _data(nullptr) {
+_server(server), _layout(layout), _id(id), _focused_window(nullptr), _output(nullptr), _data(nullptr) {
 	_name = strdup(name ? name : "");
 	_windows_history = new WindowsHistory();
+	_grid = new WindowGrid();
+
+	bool failed = false;
+	_scene_tree = Node::alloc_scene_tree(_server->root()->workspace_tree(), &failed);
+	if (failed) {
+		// TODO error
+	} else {
+		wlr_scene_node_set_enabled(&_scene_tree->node, false);
+	}
 
 	_server->add_workspace(this);
 
@@ -22,16 +34,30 @@ _server(server), _layout(layout), _id(id), _focused_window(nullptr), _data(nullp
 }
 
 Workspace::~Workspace() {
-	for (auto & cb : _on_destroy) {
-		cb(this);
+	_on_destroy.emit(this);
+
+	if (_output) {
+		_output->remove_workspace(this);
+	}
+	_server->remove_workspace(this);
+
+	// the window trees hang under ours, take them out before it is destroyed
+	std::vector<Window*> windows(_windows.begin(), _windows.end());
+	for (auto window : windows) {
+		window->set_workspace(nullptr);
 	}
 
+	if (_scene_tree) {
+		wlr_scene_node_destroy(&_scene_tree->node);
+	}
+	delete _grid;
 	free(_name);
 }
 
 Workspace & Workspace::add_window(Window * window) {
-	_windows.push_back(window);
+	_windows.insert(window);
 	_windows_history->shift(window);
+	_grid->update(window);
 	focus_window(window);
 
 	return *this;
@@ -42,24 +68,35 @@ Workspace & Workspace::remove_window(Window * window) {
 		_focused_window = _windows_history->previous();
 	}
 
-	_windows.remove(window);
+	_windows.erase(window);
 	_windows_history->remove(window);
+	_grid->remove(window);
 
 	return *this;
 }
 
 Workspace & Workspace::focus_window(Window * window) {
+	if (_focused_window) {
+		_focused_window->damage();
+	}
+
 	if (!window) {
 		_focused_window = nullptr;
 		return *this;
 	}
 
-	if (std::find(_windows.begin(), _windows.end(), window) == _windows.end()) {
+	if (!_windows.contains(window)) {
 		return *this;
 	}
 
 	_focused_window = window;
 	_windows_history->shift(window);
+	_server->windows_history()->shift(window);
+	_grid->raise(window);
+	if (window->scene_tree()) {
+		wlr_scene_node_raise_to_top(&window->scene_tree()->node);
+	}
+	window->damage();
 
 	return *this;
 }
@@ -80,14 +117,18 @@ const char * Workspace::name() const {
 	return _name;
 }
 
-std::list<Window*> Workspace::windows() const {
-	return _windows;
+std::span<Window * const> Workspace::windows() const {
+	return _windows.view();
 }
 
 WindowsHistory * Workspace::windows_history() const {
 	return _windows_history;
 }
 
+WindowGrid * Workspace::grid() const {
+	return _grid;
+}
+
 Window * Workspace::focused_window() const {
 	return _focused_window;
 }
@@ -96,18 +137,26 @@ Output * Workspace::output() const {
 	return _output;
 }
 
+struct wlr_scene_tree * Workspace::scene_tree() const {
+	return _scene_tree;
+}
+
 void * Workspace::data() const {
 	return _data;
 }
 
 Workspace & Workspace::set_output(Output * output) {
 	_output = output;
+	if (_output && _scene_tree) {
+		wlr_scene_node_set_position(&_scene_tree->node,
+			static_cast<int>(_output->x()), static_cast<int>(_output->y()));
+	}
 	return *this;
 }
 
-Workspace & Workspace::on_destroy(const Handler & handler) {
+Workspace & Workspace::on_destroy(const Handler & handler, const char * name, Subscription * subscription) {
 	if (handler) {
-		_on_destroy.push_back(std::move(handler));
+		_on_destroy.push_back(std::move(handler), name, subscription);
 	}
 	return *this;
 }
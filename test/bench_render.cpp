@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <wlkit/wlkit.hpp>
+
+extern "C" {
+#include <wlr/backend/headless.h>
+#include <wlr/backend/multi.h>
+#include <wlr/types/wlr_output.h>
+}
+
+// счётчик аллокаций C++ на время прогона
+static size_t allocations = 0;
+
+void * operator new(size_t size) {
+	++allocations;
+	if (void * ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+struct Config {
+	int outputs = 1;
+	int width = 1920;
+	int height = 1080;
+	int windows = 16;
+	int frames = 1000;
+};
+
+static Config config;
+static int exit_code = 0;
+
+static void parse_args(int argc, char ** argv) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		if (!strcmp(argv[i], "--outputs")) {
+			config.outputs = atoi(argv[i + 1]);
+		} else if (!strcmp(argv[i], "--size")) {
+			sscanf(argv[i + 1], "%dx%d", &config.width, &config.height);
+		} else if (!strcmp(argv[i], "--windows")) {
+			config.windows = atoi(argv[i + 1]);
+		} else if (!strcmp(argv[i], "--frames")) {
+			config.frames = atoi(argv[i + 1]);
+		}
+	}
+}
+
+static void draw_windows(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Render * render) {
+	struct wlr_render_rect_options bg = {
+		.box = { 0, 0, wlr_output->width, wlr_output->height },
+		.color = { 0.1f, 0.1f, 0.1f, 1.0f },
+	};
+	wlr_render_pass_add_rect(render->pass(), &bg);
+
+	auto & history = output->current_workspace()->windows_history()->history();
+	for (auto it = history.rbegin(); it != history.rend(); ++it) {
+		auto win = *it;
+		struct wlr_render_rect_options rect = {
+			.box = { (int)win->x(), (int)win->y(), (int)win->width(), (int)win->height() },
+			.color = { 0.3f, 0.5f, 0.8f, 0.9f },
+		};
+		wlr_render_pass_add_rect(render->pass(), &rect);
+	}
+}
+
+static void setup_output(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Server * server) {
+	auto state = wlkit::OutputStateBuilder{}
+		.enabled(true)
+		.render_format(wlr_output->render_format)
+		.build();
+	// частота headless-выхода задаёт темп кадров, берём с запасом
+	wlkit::Output::Mode mode = { (wlkit::Geo)config.width, (wlkit::Geo)config.height, 1000000 };
+
+	output->
+		setup_state(state.get())
+		.setup_mode(&mode)
+		.commit_state()
+		.on_frame(draw_windows);
+
+	static wlkit::Workspace::ID next_id = 1;
+	auto layout = new wlkit::Layout("floating", nullptr);
+	auto workspace = new wlkit::Workspace(server, layout, next_id++, "bench", nullptr);
+	for (int i = 0; i < config.windows; ++i) {
+		auto window = new wlkit::Window(server, workspace, nullptr, "bench", "bench");
+		window->
+			move((i * 37) % std::max(1, config.width - 320), (i * 23) % std::max(1, config.height - 240))
+			.resize(320, 240)
+			.map();
+		workspace->focus_window(window);
+	}
+	output->switch_to_workspace(workspace);
+}
+
+static void add_headless_output(struct wlr_backend * backend, void * data) {
+	if (wlr_backend_is_headless(backend)) {
+		wlr_headless_add_output(backend, config.width, config.height);
+	}
+}
+
+static int run_bench(wlkit::Server * server) {
+	for (int i = 0; i < config.outputs; ++i) {
+		wlr_multi_for_each_backend(server->backend(), add_headless_output, nullptr);
+	}
+
+	auto outputs = server->outputs();
+	if (outputs.empty()) {
+		fprintf(stderr, "bench-render: no headless outputs\n");
+		return 1;
+	}
+
+	std::vector<wlkit::Nsec> samples;
+	// с запасом: последний проход может дать по кадру сверх нормы на каждый выход
+	samples.reserve((config.frames + 1) * outputs.size());
+	std::vector<uint64_t> done(outputs.size(), 0);
+	for (size_t i = 0; i < outputs.size(); ++i) {
+		done[i] = outputs[i]->frame_stats()->frames();
+	}
+	size_t allocations_before = allocations;
+	wlkit::Nsec start = wlkit::monotonic_nsec();
+
+	// кадры идут по таймеру headless-бэкенда, wlroots сам решает, когда кадр готов
+	for (bool running = true; running; ) {
+		running = false;
+		for (size_t i = 0; i < outputs.size(); ++i) {
+			auto stats = outputs[i]->frame_stats();
+			while (stats->frames() > done[i]) {
+				auto & frame = stats->frame(stats->frames() - ++done[i]);
+				samples.push_back(frame.handler + frame.submit + frame.commit);
+			}
+			if (samples.size() < (size_t)config.frames * outputs.size()) {
+				outputs[i]->request_redraw();
+				running = true;
+			}
+		}
+		if (running) {
+			wl_event_loop_dispatch(server->event_loop(), -1);
+		}
+	}
+
+	wlkit::Nsec elapsed = wlkit::monotonic_nsec() - start;
+	size_t allocated = allocations - allocations_before;
+
+	std::sort(samples.begin(), samples.end());
+	auto percentile = [&samples](double p) {
+		return samples[(size_t)(p * (double)(samples.size() - 1))] / 1e6;
+	};
+
+	printf("outputs %d (%dx%d), windows %d, frames %d\n",
+		config.outputs, config.width, config.height, config.windows, config.frames);
+	printf("frames/s      %.1f\n", samples.size() / (elapsed / 1e9));
+	printf("frame p50     %.3f ms\n", percentile(0.5));
+	printf("frame p99     %.3f ms\n", percentile(0.99));
+	printf("allocs/frame  %.1f\n", (double)allocated / samples.size());
+	return 0;
+}
+
+static void handle_idle_start(void * data) {
+	auto server = static_cast<wlkit::Server*>(data);
+	exit_code = run_bench(server);
+	server->stop();
+}
+
+int main(int argc, char ** argv) {
+	parse_args(argc, argv);
+	if (config.frames <= 0 || config.outputs <= 0) {
+		fprintf(stderr, "usage: %s [--outputs N] [--size WxH] [--windows M] [--frames K]\n", argv[0]);
+		return 1;
+	}
+
+	wlr_log_init(WLR_ERROR, NULL);
+	unsetenv("WAYLAND_DISPLAY");
+	unsetenv("XDG_SESSION_TYPE");
+	setenv("WLR_RENDERER", "pixman", true);
+
+	auto seat = wlkit::Seat("seat0");
+	auto server = wlkit::Server(&seat, nullptr, "headless");
+
+	server
+		.on_new_output(setup_output)
+		.on_start([](auto server) {
+			// start() блокируется в wl_display_run, замер идёт из цикла событий
+			wl_event_loop_add_idle(server->event_loop(), handle_idle_start, server);
+		})
+		.start();
+
+	return exit_code;
+}
@@ -28,8 +28,6 @@ const char * MAGENTA = "\033[35m";
 const char * CYAN    = "\033[36m";
 const char * RED     = "\033[31m";
 
-static wlkit::Geo cursor_x = 0, cursor_y = 0;
-static bool cursor_state = 0;
 static wlkit::Window * moving_window = nullptr;
 
 std::string get_current_time() {
@@ -239,8 +237,6 @@ void setup_portal_env(const wlkit::Server * server) {
 }
 
 void ai_test_draw_frame(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Render * render) {
-	struct wlr_render_pass * pass = render->pass();
-
 	// Получаем время для анимации
 	time_t now = time(nullptr);
 	struct tm *tm = localtime(&now);
@@ -264,12 +260,94 @@ void ai_test_draw_frame(wlkit::Output * output, struct wlr_output * wlr_output,
 		},
 		.color = { bg_r, bg_g, bg_b, 1.0f },
 	};
-	wlr_render_pass_add_rect(pass, &bg_opts);
+	render->draw_rect(bg_opts);
+
+	int center_x = output->width() / 2;
+	int center_y = output->height() / 2;
+
+	// 6. Цифровые часы в центре
+	int clock_bg_width = 200;
+	int clock_bg_height = 80;
+	struct wlr_render_rect_options clock_bg_opts = {
+		.box = {
+			.x = center_x - clock_bg_width/2,
+			.y = center_y - clock_bg_height/2,
+			.width = clock_bg_width,
+			.height = clock_bg_height,
+		},
+		.color = { 0.0f, 0.0f, 0.0f, 0.7f },
+	};
+	render->draw_rect(clock_bg_opts);
+
+	// без эффектов следующий кадр никто не просит: часы обновляют только свой угол,
+	// а выход на таких дешёвых кадрах может вернуться в обычный режим
+	if (output->degraded()) {
+		output->damage_buffer_box(&clock_bg_opts.box);
+	}
+
+	// 7. Простая визуализация времени через полоски
+	// Часы (0-23)
+	int hour_width = (tm->tm_hour * clock_bg_width) / 24;
+	if (hour_width > 0) {
+		struct wlr_render_rect_options hour_opts = {
+			.box = {
+				.x = center_x - clock_bg_width/2,
+				.y = center_y - 30,
+				.width = hour_width,
+				.height = 15,
+			},
+			.color = { 1.0f, 0.2f, 0.2f, 0.9f },
+		};
+		render->draw_rect(hour_opts);
+	}
+
+	// Минуты (0-59)
+	int min_width = (tm->tm_min * clock_bg_width) / 60;
+	if (min_width > 0) {
+		struct wlr_render_rect_options min_opts = {
+			.box = {
+				.x = center_x - clock_bg_width/2,
+				.y = center_y - 10,
+				.width = min_width,
+				.height = 15,
+			},
+			.color = { 0.2f, 1.0f, 0.2f, 0.9f },
+		};
+		render->draw_rect(min_opts);
+	}
+
+	// Секунды (0-59)
+	int sec_width = (tm->tm_sec * clock_bg_width) / 60;
+	if (sec_width > 0) {
+		struct wlr_render_rect_options sec_opts = {
+			.box = {
+				.x = center_x - clock_bg_width/2,
+				.y = center_y + 10,
+				.width = sec_width,
+				.height = 15,
+			},
+			.color = { 0.2f, 0.2f, 1.0f, 0.9f },
+		};
+		render->draw_rect(sec_opts);
+	}
+}
+
+// анимация рисуется поверх окон и первой отключается, когда выход не успевает
+void ai_test_draw_effects(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Render * render) {
+	// Получаем время для анимации
+	time_t now = time(nullptr);
+	struct tm *tm = localtime(&now);
+	if (!tm) {
+		return;
+	};
+
+	// Общее время в секундах с начала минуты для плавной анимации
+	float time_sec = tm->tm_sec + (float)(clock() % CLOCKS_PER_SEC) / CLOCKS_PER_SEC;
 
-	// 4. Анимированные круги (имитация)
 	int center_x = output->width() / 2;
 	int center_y = output->height() / 2;
 
+	// 4. Анимированные круги (имитация)
 	for (int i = 0; i < 5; i++) {
 		float angle = time_sec * 0.5f + i * 1.26f; // 1.26 ≈ 2π/5
 		float radius = 100.0f + 50.0f * sinf(time_sec * 0.3f + i);
@@ -310,20 +388,24 @@ void ai_test_draw_frame(wlkit::Output * output, struct wlr_output * wlr_output,
 			},
 			.color = { r, g, b, 0.8f },
 		};
-		wlr_render_pass_add_rect(pass, &circle_opts);
+		render->draw_rect(circle_opts);
 	}
 
 	// 5. Волновой эффект внизу
 	int wave_height = 60;
 	int wave_y = output->height() - wave_height - 50;
 
+	// полоски волны отдаём одним списком, соседние одного цвета склеятся
+	static std::vector<wlkit::DisplayList::Rect> wave;
+	static wlkit::DisplayList wave_list;
+	wave.clear();
 	for (int x = 0; x < output->width(); x += 4) {
 		float wave_offset = sinf((x * 0.01f) + (time_sec * 2.0f)) * 20.0f;
 		int bar_height = wave_height + (int)wave_offset;
 
 		float wave_intensity = (sinf(x * 0.005f + time_sec) + 1.0f) * 0.5f;
 
-		struct wlr_render_rect_options wave_opts = {
+		wave.push_back({
 			.box = {
 				.x = x,
 				.y = wave_y - bar_height/2,
@@ -331,69 +413,9 @@ void ai_test_draw_frame(wlkit::Output * output, struct wlr_output * wlr_output,
 				.height = bar_height,
 			},
 			.color = { 0.2f + wave_intensity * 0.6f, 0.6f, 1.0f, 0.7f },
-		};
-		wlr_render_pass_add_rect(pass, &wave_opts);
-	}
-
-	// 6. Цифровые часы в центре
-	int clock_bg_width = 200;
-	int clock_bg_height = 80;
-	struct wlr_render_rect_options clock_bg_opts = {
-		.box = {
-			.x = center_x - clock_bg_width/2,
-			.y = center_y - clock_bg_height/2,
-			.width = clock_bg_width,
-			.height = clock_bg_height,
-		},
-		.color = { 0.0f, 0.0f, 0.0f, 0.7f },
-	};
-	wlr_render_pass_add_rect(pass, &clock_bg_opts);
-
-	// 7. Простая визуализация времени через полоски
-	// Часы (0-23)
-	int hour_width = (tm->tm_hour * clock_bg_width) / 24;
-	if (hour_width > 0) {
-		struct wlr_render_rect_options hour_opts = {
-			.box = {
-				.x = center_x - clock_bg_width/2,
-				.y = center_y - 30,
-				.width = hour_width,
-				.height = 15,
-			},
-			.color = { 1.0f, 0.2f, 0.2f, 0.9f },
-		};
-		wlr_render_pass_add_rect(pass, &hour_opts);
-	}
-
-	// Минуты (0-59)
-	int min_width = (tm->tm_min * clock_bg_width) / 60;
-	if (min_width > 0) {
-		struct wlr_render_rect_options min_opts = {
-			.box = {
-				.x = center_x - clock_bg_width/2,
-				.y = center_y - 10,
-				.width = min_width,
-				.height = 15,
-			},
-			.color = { 0.2f, 1.0f, 0.2f, 0.9f },
-		};
-		wlr_render_pass_add_rect(pass, &min_opts);
-	}
-
-	// Секунды (0-59)
-	int sec_width = (tm->tm_sec * clock_bg_width) / 60;
-	if (sec_width > 0) {
-		struct wlr_render_rect_options sec_opts = {
-			.box = {
-				.x = center_x - clock_bg_width/2,
-				.y = center_y + 10,
-				.width = sec_width,
-				.height = 15,
-			},
-			.color = { 0.2f, 0.2f, 1.0f, 0.9f },
-		};
-		wlr_render_pass_add_rect(pass, &sec_opts);
+		});
 	}
+	render->draw(wave_list.clear().add_rects(wave));
 
 	// 8. Частицы в углах
 	for (int corner = 0; corner < 4; corner++) {
@@ -416,9 +438,12 @@ void ai_test_draw_frame(wlkit::Output * output, struct wlr_output * wlr_output,
 				},
 				.color = { 1.0f, 1.0f, 1.0f, 0.6f },
 			};
-			wlr_render_pass_add_rect(pass, &particle_opts);
+			render->draw_rect(particle_opts);
 		}
 	}
+
+	// анимация меняет весь кадр, поэтому сразу просим следующий
+	output->request_redraw();
 }
 
 void ai_test_draw_status(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Render * render) {
@@ -445,16 +470,16 @@ void ai_test_draw_status(wlkit::Output * output, struct wlr_output * wlr_output,
 			},
 			.color = { current ? 0.2f : 0.3f, current ? 0.6f : 0.3f, current ? 0.9f : 0.3f, 1.0f }
 		};
-		wlr_render_pass_add_rect(pass, &ws_opts);
+		render->draw_rect(ws_opts);
 		idx++;
 	}
 
 	// ––––––––––––––––––––––––––––––––––––––––––
 	// 3) Окна на текущем воркспейсе
 	// ––––––––––––––––––––––––––––––––––––––––––
-	auto history = output->current_workspace()->windows_history()->history();
-	history.reverse();
-	for (auto & win : history) {
+	auto & history = output->current_workspace()->windows_history()->history();
+	for (auto it = history.rbegin(); it != history.rend(); ++it) {
+		auto win = *it;
 		if (!win->surface()) {
 			int x = win->x();
 			int y = win->y() + tab_h;  // сдвиг вниз под панель
@@ -466,7 +491,7 @@ void ai_test_draw_status(wlkit::Output * output, struct wlr_output * wlr_output,
 				.box = { .x = x, .y = y, .width = w, .height = h },
 				.color = { focused ? 0.8f : 0.5f, focused ? 0.8f : 0.5f, focused ? 0.2f : 0.5f, focused ? 0.8f : 0.5f }
 			};
-			wlr_render_pass_add_rect(pass, &w_opts);
+			render->draw_rect(w_opts);
 			continue;
 		}
 
@@ -491,7 +516,11 @@ void ai_test_draw_status(wlkit::Output * output, struct wlr_output * wlr_output,
 			auto context = static_cast<Context*>(data);
 			auto win = context->win;
 			auto output = context->output;
-			auto pass = context->pass;
+
+			// поверхность уже на аппаратном слое
+			if (output->render()->is_offloaded(surface)) {
+				return;
+			}
 
 			auto texture = wlr_surface_get_texture(surface);
 			if (!texture) {
@@ -523,25 +552,14 @@ void ai_test_draw_status(wlkit::Output * output, struct wlr_output * wlr_output,
 				.transform = output->get_transform(),
 			};
 
-			wlr_render_pass_add_texture(pass, &opts);
+			// ждёт точку acquire клиента, если тот использует explicit sync
+			output->render()->draw_surface(surface, opts);
 		}, context);
 
 		win->drawn();
 	}
 }
 
-void draw_cursor(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Render * render) {
-	struct wlr_render_pass * pass = render->pass();
-
-	const float color = cursor_state ? 1.0f : 0.0f;
-
-	struct wlr_render_rect_options rect_opts = {
-		.box = { cursor_x, cursor_y, 20, 20 },
-		.color = { color, color, color, 1.0f }
-	};
-	wlr_render_pass_add_rect(pass, &rect_opts);
-}
-
 void setup_output(wlkit::Output * output, struct wlr_output * wlr_output, wlkit::Server * server) {
 	auto state = wlkit::OutputStateBuilder{}
 		.enabled(true)
@@ -640,32 +658,17 @@ void setup_keyboard(wlkit::Keyboard * keyboard) {
 void setup_pointer(wlkit::Pointer * pointer) {
 	pointer->
 		on_motion([](auto pointer, auto dx, auto dy, auto unaccel_dx, auto unaccel_dy) {
-			cursor_x += dx;
-			cursor_y += dy;
+			// курсор двигает wlr_cursor, перерисовка кадра не нужна
 			if (moving_window) {
 				moving_window->move(moving_window->x() + dx, moving_window->y() + dy);
 			}
-
-			auto output = pointer->server()->outputs().front();
-			if (cursor_x < 0) {
-				cursor_x = output->width();
-			}
-			if (cursor_y < 0) {
-				cursor_y = output->height();
-			}
-			if (cursor_x > output->width()) {
-				cursor_x = 0;
-			}
-			if (cursor_y > output->height()) {
-				cursor_y = 0;
-			}
 		})
 		.on_button([](auto pointer, auto button, auto state) {
+			auto cursor = pointer->server()->root()->cursor();
 			if (button == 272) {
-				cursor_state = state;
 				if (state == 1) {
 					auto output = *pointer->server()->outputs().begin();
-					auto window = output->window_at(cursor_x, cursor_y);
+					auto window = output->window_at(cursor->x(), cursor->y());
 					if (window) {
 						output->current_workspace()->focus_window(window);
 						moving_window = window;
@@ -678,7 +681,7 @@ void setup_pointer(wlkit::Pointer * pointer) {
 			} else if (button == 274) {
 				if (state == 1) {
 					auto output = *pointer->server()->outputs().begin();
-					auto window = output->window_at(cursor_x, cursor_y);
+					auto window = output->window_at(cursor->x(), cursor->y());
 					if (window) {
 						window->close();
 					}
@@ -722,6 +725,7 @@ void create_defaults(wlkit::Output * output, struct wlr_output * wlr_output, wlk
 
 int main() {
 	wlr_log_init(WLR_ERROR, NULL);
+	wlkit::Profiler::set_enabled(true);
 	auto seat = wlkit::Seat("seat0");
 	auto server = wlkit::Server(&seat, setup_portal_env);
 
@@ -738,9 +742,17 @@ int main() {
 		.on_new_output([](auto output, auto wlr_output, auto server) {
 			output->server()->prefer_output(output);
 			// output->on_frame(dummy_draw_frame);
-			output->on_frame(ai_test_draw_frame);
-			output->on_frame(ai_test_draw_status);
-			output->on_frame(draw_cursor);
+			output->
+				set_frame_budget(0.5, 3)
+				.set_auto_degrade(true)
+				.on_frame(ai_test_draw_frame, "background")
+				.on_frame(ai_test_draw_status, "status")
+				.on_frame_effect(ai_test_draw_effects, "effects")
+				.on_over_budget([](auto output) {
+					// кто именно тормозит, видно в отчёте профилировщика
+					wlkit::Profiler::log(WLR_ERROR);
+					wlkit::Profiler::reset();
+				});
 		})
 		.on_new_input(setup_input)
 		.on_new_xdg_shell_toplevel([](auto window, auto xdg_surface, auto output) {